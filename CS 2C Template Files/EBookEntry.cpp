@@ -185,6 +185,47 @@ int EBookEntryReader::convertToInt(string strToCnvrt)
    istringstream(strToCnvrt) >> retInt;
    return retInt;
 }
+// EBookEntryIO methods -------------------------------------------------
+// false at the end of the file, or on a damaged record
+bool EBookEntryIO::read(istream & in, EBookEntry & book) const
+{
+   if ( !in.read((char *)&book.eTextNum, sizeof(book.eTextNum)) )
+      return false;
+   return readString(in, book.title) && readString(in, book.creator)
+      && readString(in, book.subject);
+}
+
+void EBookEntryIO::write(ostream & out, const EBookEntry & book) const
+{
+   out.write((const char *)&book.eTextNum, sizeof(book.eTextNum));
+   writeString(out, book.title);
+   writeString(out, book.creator);
+   writeString(out, book.subject);
+}
+
+bool EBookEntryIO::readString(istream & in, string & str)
+{
+   int length;
+
+   if ( !in.read((char *)&length, sizeof(length)) )
+      return false;
+   if (length < 0 || length > EBookEntry::MAX_ENTRY_LENGTH)
+   {
+      in.setstate(ios::failbit);
+      return false;
+   }
+   str.resize(length);
+   return length == 0 || (bool)in.read(&str[0], length);
+}
+
+void EBookEntryIO::writeString(ostream & out, const string & str)
+{
+   int length = str.length();
+
+   out.write((const char *)&length, sizeof(length));
+   out.write(str.data(), length);
+}
+
 // EBookEntry methods ---------------------------------------------------
 
 // static int initialization
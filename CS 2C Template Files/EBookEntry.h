@@ -2,6 +2,7 @@
 // Interface for classes
 //   EBookEntry - Single ebook object from the Project Gutenberg database
 //   EBookEntryReader - Used to read and return EBookEntry objects
+//   EBookEntryIO - reads and writes EBookEntry records for FHexternalSort
 // Author: Michael Loceff c 2009
 
 #ifndef EBookEntry_H
@@ -22,6 +23,7 @@ public:
 private:
    string title, creator, subject;
    int eTextNum;
+   friend class EBookEntryIO;
 
 public:
    static const int MIN_STRING = 1;
@@ -55,6 +57,45 @@ public:
    bool operator>(const EBookEntry &other) const;
    bool operator==(const EBookEntry &other) const;
    bool operator!=(const EBookEntry &other) const;
+
+   // per-field comparators (see FHcompare.h)
+   class ByTitle
+   {
+   public:
+      bool operator()(const EBookEntry &a, const EBookEntry &b) const
+         { return a.title < b.title; }
+   };
+   class ByCreator
+   {
+   public:
+      bool operator()(const EBookEntry &a, const EBookEntry &b) const
+         { return a.creator < b.creator; }
+   };
+   class BySubject
+   {
+   public:
+      bool operator()(const EBookEntry &a, const EBookEntry &b) const
+         { return a.subject < b.subject; }
+   };
+   class ById
+   {
+   public:
+      bool operator()(const EBookEntry &a, const EBookEntry &b) const
+         { return a.eTextNum < b.eTextNum; }
+   };
+};
+
+// RecordIO for FHexternalSort (see FHexternalSort.h).  a record is the
+// eTextNum, then each string as its length followed by its characters
+class EBookEntryIO
+{
+public:
+   bool read(istream & in, EBookEntry & book) const;
+   void write(ostream & out, const EBookEntry & book) const;
+
+private:
+   static bool readString(istream & in, string & str);
+   static void writeString(ostream & out, const string & str);
 };
 
 class EBookEntryReader
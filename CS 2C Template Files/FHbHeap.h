@@ -0,0 +1,300 @@
+// File FHbHeap.h
+// Template definitions for FHbHeap.
+// B-heap: a min heap with the same insert/top/pop/remove interface as
+// FHbinHeap, but stored so that every complete subtree of BLOCK_LEVELS
+// levels sits in one contiguous block of 2^BLOCK_LEVELS slots.  A root to
+// leaf path then touches one block (one page or a few cache lines) per
+// BLOCK_LEVELS levels instead of a new one on almost every level, which is
+// what matters once the heap is much larger than the cache or the TLB.
+//
+// Choose BLOCK_LEVELS so 2^BLOCK_LEVELS * sizeof(Comparable) is about a
+// page (4096 bytes) for huge heaps, or a few cache lines for smaller ones.
+//
+// Layout: the logical heap is the usual complete binary tree, numbered
+// 1..n in level order.  Blocks form a tree of their own (each of the
+// 2^(BLOCK_LEVELS-1) bottom nodes of a block has two child blocks) and are
+// numbered in level order too.  Inside a block, slots 1.. hold its subtree
+// in level order, slot 0 is unused.  Blocks in the deepest block level
+// are only as wide as their deepest row needs, and are re-spaced (an
+// amortized O(1) step, like an FHvector doubling) as that row deepens.
+#ifndef FHBHEAP_H
+#define FHBHEAP_H
+#include "FHvector.h"
+#include <utility>
+using namespace std;
+
+// ---------------------- FHbHeap Prototype --------------------------
+template <class Comparable, int BLOCK_LEVELS = 8>
+class FHbHeap
+{
+   static const int BLOCK_SIZE = 1 << BLOCK_LEVELS;
+   static const int FIRST_BOTTOM = BLOCK_SIZE / 2;  // first slot whose
+                                                    // children are in
+                                                    // another block
+   // a node as (block number, slot within the block)
+   class Position
+   {
+   public:
+      int block, slot;
+      Position(int b = 0, int s = 1) : block(b), slot(s) { }
+   };
+
+private:
+   FHvector<Comparable> mArray;
+   int mSize;
+   int mLastLevel;      // deepest block level the layout has room for
+   int mFirstLast;      // number of the first block in that level
+   int mLastBase;       // index in mArray where that level starts
+   int mLastStride;     // width of each block in that level
+
+public:
+   FHbHeap();
+   FHbHeap(const FHvector<Comparable> & items);
+   bool empty() const { return mSize == 0; }
+   void makeEmpty() { mSize = 0; }
+   void insert(const Comparable & x);
+   const Comparable & top() const;
+   Comparable pop();
+   Comparable remove() { return pop(); }
+
+   int size() const { return mSize; }
+
+   // for exception throwing
+   class HeapEmptyException { };
+
+private:
+   int index(const Position & pos) const;
+   Position positionOf(int node) const;
+   Position parent(const Position & pos) const;
+   Position leftChild(const Position & pos) const;
+   void makeRoomFor(int node);
+   void percolateDown(int node, Position pos);
+   static int log2Floor(int n);
+   static int firstBlockInLevel(int level);
+};
+
+// FHbHeap method definitions -------------------
+template <class Comparable, int BLOCK_LEVELS>
+FHbHeap<Comparable, BLOCK_LEVELS>::FHbHeap()
+   : mSize(0), mLastLevel(0), mFirstLast(0), mLastBase(0), mLastStride(2)
+{
+   static_assert(BLOCK_LEVELS >= 2 && BLOCK_LEVELS <= 16,
+      "FHbHeap BLOCK_LEVELS must be in [2, 16]");
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+FHbHeap<Comparable, BLOCK_LEVELS>::FHbHeap(const FHvector<Comparable> & items)
+   : mSize(0), mLastLevel(0), mFirstLast(0), mLastBase(0), mLastStride(2)
+{
+   int k, numItems = items.size();
+
+   // copy in level order - no ordering yet
+   for (k = 1; k <= numItems; k++)
+   {
+      makeRoomFor(k);
+      mArray[index(positionOf(k))] = items[k - 1];
+   }
+   mSize = numItems;
+
+   // order the heap
+   for (k = mSize / 2; k > 0; k--)
+      percolateDown(k, positionOf(k));
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+int FHbHeap<Comparable, BLOCK_LEVELS>::log2Floor(int n)
+{
+   int log = 0;
+
+#if defined(__GNUC__)
+   log = 31 - __builtin_clz((unsigned int)n);
+#else
+   for ( ; n > 1; n >>= 1)
+      log++;
+#endif
+   return log;
+}
+
+// 1 + F + F^2 + ... (level - 1 terms), F = BLOCK_SIZE
+template <class Comparable, int BLOCK_LEVELS>
+int FHbHeap<Comparable, BLOCK_LEVELS>::firstBlockInLevel(int level)
+{
+   int k, first = 0;
+
+   for (k = 0; k < level; k++)
+      first = first * BLOCK_SIZE + 1;
+   return first;
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+int FHbHeap<Comparable, BLOCK_LEVELS>::index(const Position & pos) const
+{
+   if (pos.block < mFirstLast)
+      return pos.block * BLOCK_SIZE + pos.slot;
+   return mLastBase + (pos.block - mFirstLast) * mLastStride + pos.slot;
+}
+
+// where logical node number "node" (1 = root) lives
+template <class Comparable, int BLOCK_LEVELS>
+typename FHbHeap<Comparable, BLOCK_LEVELS>::Position
+   FHbHeap<Comparable, BLOCK_LEVELS>::positionOf(int node) const
+{
+   int depth, level, row, blockRoot;
+
+   depth = log2Floor(node);
+   level = depth / BLOCK_LEVELS;
+   row = depth % BLOCK_LEVELS;
+   blockRoot = node >> row;
+   return Position(
+      firstBlockInLevel(level) + blockRoot - (1 << (level * BLOCK_LEVELS)),
+      (1 << row) | (node & ((1 << row) - 1)) );
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+typename FHbHeap<Comparable, BLOCK_LEVELS>::Position
+   FHbHeap<Comparable, BLOCK_LEVELS>::parent(const Position & pos) const
+{
+   int k;
+
+   if (pos.slot > 1)
+      return Position(pos.block, pos.slot / 2);
+
+   // block root: parent is a bottom slot of the parent block
+   k = pos.block - 1;
+   return Position(k / BLOCK_SIZE, FIRST_BOTTOM + (k % BLOCK_SIZE) / 2);
+}
+
+// the right child is the next slot, or the root of the next block
+template <class Comparable, int BLOCK_LEVELS>
+typename FHbHeap<Comparable, BLOCK_LEVELS>::Position
+   FHbHeap<Comparable, BLOCK_LEVELS>::leftChild(const Position & pos) const
+{
+   if (pos.slot < FIRST_BOTTOM)
+      return Position(pos.block, 2 * pos.slot);
+   return Position(pos.block * BLOCK_SIZE + 1
+      + 2 * (pos.slot - FIRST_BOTTOM), 1);
+}
+
+// grows mArray (and widens the bottom blocks if needed) so that logical
+// node number "node" has a slot
+template <class Comparable, int BLOCK_LEVELS>
+void FHbHeap<Comparable, BLOCK_LEVELS>::makeRoomFor(int node)
+{
+   int depth, level, newStride, block, slot, numBlocks;
+
+   depth = log2Floor(node);
+   level = depth / BLOCK_LEVELS;
+   newStride = 2 << (depth % BLOCK_LEVELS);
+
+   if (level > mLastLevel)
+   {
+      // the old bottom level was BLOCK_SIZE wide already; start a new one
+      mLastLevel = level;
+      mFirstLast = firstBlockInLevel(level);
+      mLastBase = mFirstLast * BLOCK_SIZE;
+      mLastStride = newStride;
+   }
+   else if (newStride > mLastStride)
+   {
+      // bottom level gets a new row: re-space its blocks, last one first.
+      // every row above the new one is full, so all its blocks are in use
+      numBlocks = 1 << (mLastLevel * BLOCK_LEVELS);
+      mArray.resize(mLastBase + numBlocks * newStride);
+      for (block = numBlocks - 1; block > 0; block--)
+         for (slot = mLastStride - 1; slot > 0; slot--)
+            mArray[mLastBase + block * newStride + slot]
+               = std::move(mArray[mLastBase + block * mLastStride + slot]);
+      mLastStride = newStride;
+   }
+
+   if (index(positionOf(node)) >= mArray.size())
+      mArray.resize(index(positionOf(node)) + 1);
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+void FHbHeap<Comparable, BLOCK_LEVELS>::insert(const Comparable & x)
+{
+   int node;
+   Position hole, up;
+
+   makeRoomFor(mSize + 1);
+
+   // percolate up
+   node = ++mSize;
+   hole = positionOf(node);
+   for( ; node > 1; node /= 2, hole = up )
+   {
+      up = parent(hole);
+      if ( !(x < mArray[index(up)]) )
+         break;
+      mArray[index(hole)] = std::move(mArray[index(up)]);
+   }
+   mArray[index(hole)] = x;
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+const Comparable & FHbHeap<Comparable, BLOCK_LEVELS>::top() const
+{
+   if( empty() )
+      throw HeapEmptyException();
+   return mArray[index(Position())];
+}
+
+template <class Comparable, int BLOCK_LEVELS>
+Comparable FHbHeap<Comparable, BLOCK_LEVELS>::pop()
+{
+   int rootIndex;
+
+   if( empty() )
+      throw HeapEmptyException();
+
+   rootIndex = index(Position());
+   Comparable minObject = std::move(mArray[rootIndex]);
+
+   if (--mSize > 0)
+   {
+      mArray[rootIndex] = std::move(mArray[index(positionOf(mSize + 1))]);
+      percolateDown(1, Position());
+   }
+
+   return minObject;
+}
+
+// node is the logical number of pos; it tells us when children run out
+template <class Comparable, int BLOCK_LEVELS>
+void FHbHeap<Comparable, BLOCK_LEVELS>::percolateDown(int node, Position pos)
+{
+   int child, childIndex, rightIndex;
+   Position childPos;
+   Comparable tmp = std::move(mArray[index(pos)]);
+
+   for( ; (child = 2 * node) <= mSize; node = child, pos = childPos )
+   {
+      childPos = leftChild(pos);
+      childIndex = index(childPos);
+
+      // if 2 children, get the lesser of the two
+      if (child < mSize)
+      {
+         if (childPos.slot == 1)
+            rightIndex = index(Position(childPos.block + 1, 1));
+         else
+            rightIndex = childIndex + 1;
+         if( mArray[rightIndex] < mArray[childIndex] )
+         {
+            child++;
+            childIndex = rightIndex;
+            childPos = childPos.slot == 1 ?
+               Position(childPos.block + 1, 1) :
+               Position(childPos.block, childPos.slot + 1);
+         }
+      }
+      if( mArray[childIndex] < tmp )
+         mArray[index(pos)] = std::move(mArray[childIndex]);
+      else
+         break;
+   }
+   mArray[index(pos)] = std::move(tmp);
+}
+
+#endif
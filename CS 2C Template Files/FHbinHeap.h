@@ -1,29 +1,39 @@
 // File FHbinHeap.h
-// Template definitions for FHbinHeap.  
+// Template definitions for FHbinHeap.
 // Binary heaps for priority queues and heap sorts
+// ARITY selects a d-ary heap (4 or 8 keeps all children of a node within
+// one or two cache lines for small Comparables); 2 is the classic binary heap.
+// Compare orders the heap (see FHcompare.h); the top is the least item
 #ifndef FHBINHEAP_H
 #define FHBINHEAP_H
 #include "FHvector.h"
+#include "FHcompare.h"
+#include <utility>
 using namespace std;
 
 // ---------------------- FHbinHeap Prototype --------------------------
-template <class Comparable>
+template <class Comparable, int ARITY = 2,
+   class Compare = FHless<Comparable> >
 class FHbinHeap
 {
-   static const int INIT_CAPACITY = 64; // perfect tree of size 63
+   static const int INIT_CAPACITY = 64;
 
 private:
    FHvector<Comparable> mArray;
    int mSize;
    int mCapacity;
+   Compare mLess;
 
 public:
-   FHbinHeap(int capacity = INIT_CAPACITY);
-   FHbinHeap(const FHvector<Comparable> & items );
+   FHbinHeap(int capacity = INIT_CAPACITY, Compare less = Compare());
+   FHbinHeap(const FHvector<Comparable> & items, Compare less = Compare());
    bool empty() const { return mSize == 0; }
    void makeEmpty() { mSize = 0; };
    void insert(const Comparable & x);
-   Comparable & remove();
+   const Comparable & top() const;
+   Comparable pop();
+   Comparable remove() { return pop(); }   // older name for pop()
+   Comparable replaceTop(const Comparable & x);
 
    int size() const { return mSize; }
 
@@ -33,17 +43,18 @@ public:
 private:
    void orderHeap();
    void percolateDown( int hole );
+   static int parent(int k) { return (k - 1) / ARITY; }
+   static int firstChild(int k) { return ARITY * k + 1; }
 };
 
 // FHbinHeap method definitions -------------------
-template <class Comparable>
-FHbinHeap<Comparable>::FHbinHeap(int capacity)
+template <class Comparable, int ARITY, class Compare>
+FHbinHeap<Comparable, ARITY, Compare>::FHbinHeap(int capacity,
+   Compare less)
+   : mLess(less)
 {
-   // choose a capacity that is exactly 2^N - 1 for some N (esthetic)
-   // which leads to mCapacity 2^N, internally -- user asks for 127, we
-   // reserve 128, if they want 128, we have to reserve 256.
-   for (mCapacity = INIT_CAPACITY; 
-      mCapacity <= capacity;
+   for (mCapacity = INIT_CAPACITY;
+      mCapacity < capacity;
       mCapacity = 2 * mCapacity
       )
    {
@@ -57,92 +68,122 @@ FHbinHeap<Comparable>::FHbinHeap(int capacity)
    makeEmpty();
 }
 
-template <class Comparable>
-FHbinHeap<Comparable>::FHbinHeap( const FHvector<Comparable> & items )
-: mSize(items.size())
+template <class Comparable, int ARITY, class Compare>
+FHbinHeap<Comparable, ARITY, Compare>::FHbinHeap(
+   const FHvector<Comparable> & items, Compare less )
+: mSize(items.size()), mLess(less)
 {
    int k;
 
-   // find the first perfect tree size > items.size() and INIT_CAPACITY
-   for (mCapacity = INIT_CAPACITY; 
-      mCapacity <= mSize;
+   for (mCapacity = INIT_CAPACITY;
+      mCapacity < mSize;
       mCapacity = 2 * mCapacity
       )
    {
       if (mCapacity < 0)
-         mCapacity = mSize + 1; // give up - overflow, and not perfect
+      {
+         mCapacity = mSize; // give up - overflow
+         break;
+      }
    }
    mArray.resize(mCapacity);
 
-   // copy starting with position 1 - no ordering yet
+   // copy starting with position 0 - no ordering yet
    for(k = 0; k < mSize; k++ )
-      mArray[k+1] = items[k];
+      mArray[k] = items[k];
 
    // order the heap
    orderHeap( );
 }
 
-template <class Comparable>
-void FHbinHeap<Comparable>::insert(const Comparable & x)
+template <class Comparable, int ARITY, class Compare>
+void FHbinHeap<Comparable, ARITY, Compare>::insert(const Comparable & x)
 {
    int hole;
 
-   if( mSize == mCapacity - 1 )
+   if( mSize == mCapacity )
    {
       mCapacity = 2 * mCapacity;
       mArray.resize(mCapacity);
    }
 
    // percolate up
-   hole = ++mSize;
-   for( ; hole > 1 && x < mArray[hole/2]; hole /= 2 )
-      mArray[hole] = mArray[hole/2];
+   hole = mSize++;
+   for( ; hole > 0 && mLess(x, mArray[parent(hole)]); hole = parent(hole) )
+      mArray[hole] = std::move(mArray[parent(hole)]);
    mArray[hole] = x;
 }
 
-template <class Comparable>
-Comparable & FHbinHeap<Comparable>::remove()
+template <class Comparable, int ARITY, class Compare>
+const Comparable & FHbinHeap<Comparable, ARITY, Compare>::top() const
 {
-   static Comparable minObject;
+   if( empty() )
+      throw HeapEmptyException();
+   return mArray[0];
+}
 
+// moves the min out by value; nothing is kept in the heap that a later
+// call could overwrite
+template <class Comparable, int ARITY, class Compare>
+Comparable FHbinHeap<Comparable, ARITY, Compare>::pop()
+{
    if( empty() )
       throw HeapEmptyException();
 
-   minObject = mArray[1];
+   Comparable minObject = std::move(mArray[0]);
 
-   mArray[1] = mArray[mSize--];
-   percolateDown(1);
+   if (--mSize > 0)
+   {
+      mArray[0] = std::move(mArray[mSize]);
+      percolateDown(0);
+   }
 
    return minObject;
 }
 
-template <class Comparable>
-void FHbinHeap<Comparable>::percolateDown(int hole)
-{ 
-   int child;
-   Comparable tmp;
+// pop() then insert(x) with a single percolate; returns the old top
+template <class Comparable, int ARITY, class Compare>
+Comparable FHbinHeap<Comparable, ARITY, Compare>::replaceTop(
+   const Comparable & x)
+{
+   if( empty() )
+      throw HeapEmptyException();
+
+   Comparable oldTop = std::move(mArray[0]);
+
+   mArray[0] = x;
+   percolateDown(0);
+   return oldTop;
+}
+
+template <class Comparable, int ARITY, class Compare>
+void FHbinHeap<Comparable, ARITY, Compare>::percolateDown(int hole)
+{
+   int child, k, lastChild;
+   Comparable tmp = std::move(mArray[hole]);
 
-   for( tmp = mArray[hole]; 2 * hole <= mSize; hole = child )
+   for( ; (child = firstChild(hole)) < mSize; hole = child )
    {
-      child = 2 * hole;
-      // if 2 children, get the lesser of the two
-      if( child < mSize && mArray[child + 1] < mArray[child] )
-         child++;
-      if( mArray[child] < tmp )
-         mArray[hole] = mArray[child];
+      // get the least of the (up to ARITY) children
+      lastChild = child + ARITY < mSize ? child + ARITY : mSize;
+      for (k = child + 1; k < lastChild; k++)
+         if( mLess(mArray[k], mArray[child]) )
+            child = k;
+      if( mLess(mArray[child], tmp) )
+         mArray[hole] = std::move(mArray[child]);
       else
          break;
    }
-   mArray[hole] = tmp;
+   mArray[hole] = std::move(tmp);
 }
 
-template <class Comparable>
-void FHbinHeap<Comparable>::orderHeap()
+template <class Comparable, int ARITY, class Compare>
+void FHbinHeap<Comparable, ARITY, Compare>::orderHeap()
 {
    int k;
 
-   for(k = mSize/2; k > 0; k-- )
+   for(k = parent(mSize - 1); k >= 0; k-- )
       percolateDown(k);
 }
 
-#endif
\ No newline at end of file
+#endif
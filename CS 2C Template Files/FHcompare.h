@@ -0,0 +1,47 @@
+// File FHcompare.h
+// Comparator helpers for the FH sorts and heaps.  Every sort in FHsort.h
+// and Foothill_Sort.h, and FHbinHeap, takes a comparator: any function or
+// functor less(a, b) that returns true when a belongs before b.  Passing
+// one per call (instead of setting a static sort key that operator<
+// switches on) lets each sort be compiled for its own ordering, and lets
+// two sorts on different keys run at the same time.
+//    quickSort(books, EBookEntry::ByTitle());
+//    quickSort(tunes, byKey([](const iTunesEntry & t) { return t.getTime(); }));
+#ifndef FHCOMPARE_H
+#define FHCOMPARE_H
+
+// the default: uses Comparable's operator<
+template <class Comparable>
+class FHless
+{
+public:
+   bool operator()(const Comparable & a, const Comparable & b) const
+   {
+      return a < b;
+   }
+};
+
+// orders by getKey(a) < getKey(b), for any key extractor getKey
+template <class KeyFunc>
+class FHkeyLess
+{
+private:
+   KeyFunc getKey;
+
+public:
+   FHkeyLess(KeyFunc keyFunc) : getKey(keyFunc) { }
+
+   template <class Comparable>
+   bool operator()(const Comparable & a, const Comparable & b) const
+   {
+      return getKey(a) < getKey(b);
+   }
+};
+
+template <class KeyFunc>
+FHkeyLess<KeyFunc> byKey(KeyFunc getKey)
+{
+   return FHkeyLess<KeyFunc>(getKey);
+}
+
+#endif
@@ -0,0 +1,295 @@
+// File FHcounted.h
+// Definitions for FHcounts, FHcountScope, FHcounted and FHcountedCompare.
+// FHcounted<Object> holds an Object and counts everything done to it:
+// comparisons, default and value constructions, copies, moves, copy and
+// move assignments, destructions.  It has the operators the FH containers
+// and algorithms use (<, ==, ..., Hash()), so FHsort.h, FHbinHeap,
+// FHsearch_tree, FHhashQP, FHhashSC, ... run on it unchanged and the
+// counts show what they really cost, hidden copies included:
+//    FHvector< FHcounted<int> > v;
+//    ...
+//    {
+//       FHcountScope scope("quickSort");
+//       quickSort(v);
+//    }  // prints   quickSort: compares 144804, constructs 0, copies ...
+//
+// Counters are per thread (no locking or atomics on the counted
+// operations).  FHcounts::total() sums every thread's counters, so work
+// done on an FHthreadPool is included; read it once that work has been
+// waited for.
+#ifndef FHCOUNTED_H
+#define FHCOUNTED_H
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <utility>
+using namespace std;
+
+// ---------------------- FHcounts Prototype --------------------------
+class FHcounts
+{
+public:
+   long long compares, constructs, copies, moves, copyAssigns, moveAssigns,
+      destructs;
+
+   FHcounts() { reset(); }
+   void reset()
+   {
+      compares = constructs = copies = moves = copyAssigns = moveAssigns
+         = destructs = 0;
+   }
+
+   // every time an Object was copied or moved, by constructor or assignment
+   long long transfers() const
+      { return copies + moves + copyAssigns + moveAssigns; }
+
+   FHcounts & operator+=(const FHcounts & rhs);
+   FHcounts operator-(const FHcounts & rhs) const;
+
+   // this thread's counters, and the sum over all threads
+   static FHcounts & local();
+   static FHcounts total();
+
+private:
+   class Registry;
+   class ThreadCounts;
+   static Registry & registry();
+};
+
+// each thread's counters are registered here while the thread runs; when
+// it ends they are added to retired
+class FHcounts::Registry
+{
+public:
+   mutex lock;
+   vector<FHcounts *> live;
+   FHcounts retired;
+};
+
+class FHcounts::ThreadCounts
+{
+public:
+   FHcounts counts;
+   ThreadCounts();
+   ~ThreadCounts();
+};
+
+// FHcounts method definitions -------------------
+inline FHcounts & FHcounts::operator+=(const FHcounts & rhs)
+{
+   compares += rhs.compares;
+   constructs += rhs.constructs;
+   copies += rhs.copies;
+   moves += rhs.moves;
+   copyAssigns += rhs.copyAssigns;
+   moveAssigns += rhs.moveAssigns;
+   destructs += rhs.destructs;
+   return *this;
+}
+
+inline FHcounts FHcounts::operator-(const FHcounts & rhs) const
+{
+   FHcounts diff;
+
+   diff.compares = compares - rhs.compares;
+   diff.constructs = constructs - rhs.constructs;
+   diff.copies = copies - rhs.copies;
+   diff.moves = moves - rhs.moves;
+   diff.copyAssigns = copyAssigns - rhs.copyAssigns;
+   diff.moveAssigns = moveAssigns - rhs.moveAssigns;
+   diff.destructs = destructs - rhs.destructs;
+   return diff;
+}
+
+inline FHcounts::Registry & FHcounts::registry()
+{
+   static Registry theRegistry;
+   return theRegistry;
+}
+
+inline FHcounts::ThreadCounts::ThreadCounts()
+{
+   Registry & reg = registry();
+   lock_guard<mutex> guard(reg.lock);
+
+   reg.live.push_back(&counts);
+}
+
+inline FHcounts::ThreadCounts::~ThreadCounts()
+{
+   Registry & reg = registry();
+   lock_guard<mutex> guard(reg.lock);
+   int k;
+
+   reg.retired += counts;
+   for (k = 0; k < (int)reg.live.size(); k++)
+      if (reg.live[k] == &counts)
+      {
+         reg.live[k] = reg.live.back();
+         reg.live.pop_back();
+         break;
+      }
+}
+
+inline FHcounts & FHcounts::local()
+{
+   static thread_local ThreadCounts mine;
+   return mine.counts;
+}
+
+inline FHcounts FHcounts::total()
+{
+   Registry & reg = registry();
+   lock_guard<mutex> guard(reg.lock);
+   FHcounts sum = reg.retired;
+   int k;
+
+   for (k = 0; k < (int)reg.live.size(); k++)
+      sum += *reg.live[k];
+   return sum;
+}
+
+inline ostream & operator<<(ostream & out, const FHcounts & counts)
+{
+   out << "compares " << counts.compares
+      << ", constructs " << counts.constructs
+      << ", copies " << counts.copies
+      << ", moves " << counts.moves
+      << ", copy assigns " << counts.copyAssigns
+      << ", move assigns " << counts.moveAssigns
+      << ", destructs " << counts.destructs;
+   return out;
+}
+
+// ---------------------- FHcountScope Prototype --------------------------
+// the counts (over all threads) from its construction until now; prints
+// them, with its name, when it goes out of scope
+class FHcountScope
+{
+private:
+   string mName;
+   ostream *mOut;
+   FHcounts mStart;
+
+public:
+   FHcountScope(const string & name, ostream & out = cout)
+      : mName(name), mOut(&out), mStart(FHcounts::total()) { }
+   ~FHcountScope() { *mOut << mName << ": " << counts() << endl; }
+
+   FHcounts counts() const { return FHcounts::total() - mStart; }
+
+private:
+   FHcountScope(const FHcountScope & rhs);
+   FHcountScope & operator=(const FHcountScope & rhs);
+};
+
+// ---------------------- FHcounted Prototype --------------------------
+template <class Object>
+class FHcounted
+{
+private:
+   Object mItem;
+
+public:
+   FHcounted() : mItem() { FHcounts::local().constructs++; }
+   FHcounted(const Object & x) : mItem(x) { FHcounts::local().constructs++; }
+   FHcounted(const FHcounted & rhs) : mItem(rhs.mItem)
+      { FHcounts::local().copies++; }
+   FHcounted(FHcounted && rhs) : mItem(std::move(rhs.mItem))
+      { FHcounts::local().moves++; }
+   ~FHcounted() { FHcounts::local().destructs++; }
+
+   FHcounted & operator=(const FHcounted & rhs)
+   {
+      FHcounts::local().copyAssigns++;
+      mItem = rhs.mItem;
+      return *this;
+   }
+   FHcounted & operator=(FHcounted && rhs)
+   {
+      FHcounts::local().moveAssigns++;
+      mItem = std::move(rhs.mItem);
+      return *this;
+   }
+
+   // the wrapped Object, e.g. for a key function: not counted
+   const Object & item() const { return mItem; }
+   operator const Object &() const { return mItem; }
+};
+
+// comparisons use Object's operator< and operator==
+template <class Object>
+bool operator<(const FHcounted<Object> & a, const FHcounted<Object> & b)
+{
+   FHcounts::local().compares++;
+   return a.item() < b.item();
+}
+
+template <class Object>
+bool operator>(const FHcounted<Object> & a, const FHcounted<Object> & b)
+{
+   return b < a;
+}
+
+template <class Object>
+bool operator<=(const FHcounted<Object> & a, const FHcounted<Object> & b)
+{
+   return !(b < a);
+}
+
+template <class Object>
+bool operator>=(const FHcounted<Object> & a, const FHcounted<Object> & b)
+{
+   return !(a < b);
+}
+
+template <class Object>
+bool operator==(const FHcounted<Object> & a, const FHcounted<Object> & b)
+{
+   FHcounts::local().compares++;
+   return a.item() == b.item();
+}
+
+template <class Object>
+bool operator!=(const FHcounted<Object> & a, const FHcounted<Object> & b)
+{
+   return !(a == b);
+}
+
+// for FHhashQP and FHhashSC.  Hash(Object) must be declared before this
+// file is included (as the hash tables need it before theirs)
+template <class Object>
+int Hash(const FHcounted<Object> & x)
+{
+   return Hash(x.item());
+}
+
+template <class Object>
+ostream & operator<<(ostream & out, const FHcounted<Object> & x)
+{
+   return out << x.item();
+}
+
+// ---------------------- FHcountedCompare Prototype --------------------------
+// adapts a comparator for Objects (see FHcompare.h) to FHcounted<Object>s,
+// counting each call:  quickSort(v, FHcountedCompare<EBookEntry::ByTitle>());
+template <class Compare>
+class FHcountedCompare
+{
+private:
+   Compare mLess;
+
+public:
+   FHcountedCompare(Compare less = Compare()) : mLess(less) { }
+
+   template <class Object>
+   bool operator()(const FHcounted<Object> & a,
+      const FHcounted<Object> & b) const
+   {
+      FHcounts::local().compares++;
+      return mLess(a.item(), b.item());
+   }
+};
+
+#endif
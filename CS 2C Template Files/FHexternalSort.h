@@ -0,0 +1,558 @@
+// File FHexternalSort.h
+// Template definitions for FHexternalSort, FHrunReader and FHrunWriter.
+// External merge sort for more records than fit in memory: records are
+// collected in fixed-size chunks, each chunk is sorted in memory by
+// parallelMergeSort and spilled to a temporary run file, and the runs are
+// then merged by FHkWayMerge, several passes if there are too many runs to
+// merge at once.  All file I/O is sequential and double-buffered: while
+// one block of a file is being used, the next is read (or the previous
+// written) on another thread.  The sort is stable.
+//
+// RecordIO says how a record is stored in a file:
+//    bool read(istream & in, Comparable & x) const;  // false at end
+//    void write(ostream & out, const Comparable & x) const;
+// FHrawRecordIO, the default, stores the raw bytes of a trivially copyable
+// record.  Records with strings need their own RecordIO, like EBookEntryIO
+// (EBookEntry.h; see FHexternalSortClient.cpp).
+//
+// Use:
+//    FHexternalSort<Rec> sorter(1000000);      // ~1M records in memory
+//    while (...) sorter.add(rec);
+//    sorter.finish();
+//    while (sorter.next(rec)) ...;            // or sorter.writeTo(file)
+#ifndef FHEXTERNALSORT_H
+#define FHEXTERNALSORT_H
+#include "FHparallelSort.h"
+#include "FHkWayMerge.h"
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <sstream>
+#include <future>
+#include <type_traits>
+using namespace std;
+
+// ---------------------- FHrawRecordIO Prototype --------------------------
+template <class Comparable>
+class FHrawRecordIO
+{
+public:
+   bool read(istream & in, Comparable & x) const
+   {
+      static_assert(is_trivially_copyable<Comparable>::value,
+         "FHrawRecordIO requires a trivially copyable record");
+      return (bool)in.read((char *)&x, sizeof(Comparable));
+   }
+   void write(ostream & out, const Comparable & x) const
+   {
+      out.write((const char *)&x, sizeof(Comparable));
+   }
+};
+
+// ---------------------- FHrunReader Prototype --------------------------
+// reads a record file front to back; the Run interface of FHkWayMerge
+template <class Comparable, class RecordIO = FHrawRecordIO<Comparable> >
+class FHrunReader
+{
+private:
+   ifstream mFile;
+   RecordIO mIO;
+   FHvector<Comparable> mBlock[2];
+   int mCur, mPos, mCount, mBlockSize;
+   future<int> mNext;       // count of records read into mBlock[1 - mCur]
+
+public:
+   FHrunReader() : mCur(0), mPos(0), mCount(0), mBlockSize(0) { }
+   ~FHrunReader() { close(); }
+   bool open(const string & fileName, int blockSize,
+      const RecordIO & io = RecordIO());
+   void close();
+   bool empty() const { return mPos >= mCount; }
+   const Comparable & front() const { return mBlock[mCur][mPos]; }
+   void advance();
+
+private:
+   // owns a file and a thread - not copyable
+   FHrunReader(const FHrunReader & rhs);
+   FHrunReader & operator=(const FHrunReader & rhs);
+
+   int readBlock(int which);
+   void startRead();
+};
+
+// FHrunReader method definitions -------------------
+template <class Comparable, class RecordIO>
+bool FHrunReader<Comparable, RecordIO>::open(const string & fileName,
+   int blockSize, const RecordIO & io)
+{
+   close();
+   mFile.open(fileName.c_str(), ios::in | ios::binary);
+   if (!mFile)
+      return false;
+
+   mIO = io;
+   mBlockSize = blockSize < 1 ? 1 : blockSize;
+   mBlock[0].resize(mBlockSize);
+   mBlock[1].resize(mBlockSize);
+   mCur = mPos = 0;
+   mCount = readBlock(mCur);
+   if (mCount == mBlockSize)
+      startRead();
+   return true;
+}
+
+template <class Comparable, class RecordIO>
+void FHrunReader<Comparable, RecordIO>::close()
+{
+   if (mNext.valid())
+      mNext.get();
+   if (mFile.is_open())
+      mFile.close();
+   mPos = mCount = 0;
+}
+
+template <class Comparable, class RecordIO>
+int FHrunReader<Comparable, RecordIO>::readBlock(int which)
+{
+   int k;
+
+   for (k = 0; k < mBlockSize && mIO.read(mFile, mBlock[which][k]); k++)
+      ;
+   return k;
+}
+
+// reads the next block on another thread while the caller uses this one
+template <class Comparable, class RecordIO>
+void FHrunReader<Comparable, RecordIO>::startRead()
+{
+   int which = 1 - mCur;
+
+   mNext = async(launch::async, [this, which]() { return readBlock(which); });
+}
+
+template <class Comparable, class RecordIO>
+void FHrunReader<Comparable, RecordIO>::advance()
+{
+   if (++mPos < mCount)
+      return;
+
+   // block used up: switch to the one read in the background, if any
+   mPos = mCount = 0;
+   if (!mNext.valid())
+      return;
+   mCount = mNext.get();
+   mCur = 1 - mCur;
+   if (mCount == mBlockSize)
+      startRead();
+}
+
+// ---------------------- FHrunWriter Prototype --------------------------
+// writes a record file front to back
+template <class Comparable, class RecordIO = FHrawRecordIO<Comparable> >
+class FHrunWriter
+{
+private:
+   ofstream mFile;
+   RecordIO mIO;
+   FHvector<Comparable> mBlock[2];
+   int mCur, mCount, mBlockSize;
+   future<void> mWriting;   // mBlock[1 - mCur] going out to the file
+
+public:
+   FHrunWriter() : mCur(0), mCount(0), mBlockSize(0) { }
+   ~FHrunWriter() { close(); }
+   bool open(const string & fileName, int blockSize,
+      const RecordIO & io = RecordIO());
+   bool close();
+   void put(const Comparable & x);
+
+private:
+   // owns a file and a thread - not copyable
+   FHrunWriter(const FHrunWriter & rhs);
+   FHrunWriter & operator=(const FHrunWriter & rhs);
+
+   void flush();
+};
+
+// FHrunWriter method definitions -------------------
+template <class Comparable, class RecordIO>
+bool FHrunWriter<Comparable, RecordIO>::open(const string & fileName,
+   int blockSize, const RecordIO & io)
+{
+   close();
+   mFile.open(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+   if (!mFile)
+      return false;
+
+   mIO = io;
+   mBlockSize = blockSize < 1 ? 1 : blockSize;
+   mBlock[0].resize(mBlockSize);
+   mBlock[1].resize(mBlockSize);
+   mCur = mCount = 0;
+   return true;
+}
+
+// writes what is buffered; false if any write failed
+template <class Comparable, class RecordIO>
+bool FHrunWriter<Comparable, RecordIO>::close()
+{
+   bool ok;
+
+   if (!mFile.is_open())
+      return true;
+   if (mCount > 0)
+      flush();
+   if (mWriting.valid())
+      mWriting.get();
+   ok = !mFile.fail();
+   mFile.close();
+   return ok && !mFile.fail();
+}
+
+template <class Comparable, class RecordIO>
+void FHrunWriter<Comparable, RecordIO>::put(const Comparable & x)
+{
+   mBlock[mCur][mCount++] = x;
+   if (mCount == mBlockSize)
+      flush();
+}
+
+// hands the full block to another thread and starts filling the other
+template <class Comparable, class RecordIO>
+void FHrunWriter<Comparable, RecordIO>::flush()
+{
+   int which = mCur, count = mCount;
+
+   if (mWriting.valid())
+      mWriting.get();
+   mWriting = async(launch::async, [this, which, count]()
+   {
+      int k;
+
+      for (k = 0; k < count; k++)
+         mIO.write(mFile, mBlock[which][k]);
+   });
+   mCur = 1 - mCur;
+   mCount = 0;
+}
+
+// ---------------------- FHexternalSort Prototype --------------------------
+template <class Comparable, class Compare = FHless<Comparable>,
+   class RecordIO = FHrawRecordIO<Comparable> >
+class FHexternalSort
+{
+   typedef FHrunReader<Comparable, RecordIO> Reader;
+   typedef FHkWayMerge<Comparable, Reader, Compare> Merger;
+
+   static const int MIN_BLOCK = 1024;   // records per I/O block, at least
+
+private:
+   int mMemoryRecords;
+   string mTempPrefix;
+   int mTempCount;
+   Compare mLess;
+   RecordIO mIO;
+   FHthreadPool mPool;
+   FHvector<Comparable> mChunk;   // records not yet in a run
+   FHvector<string> mRuns;        // run files, in input order
+   bool mFinished;
+
+   // output: from mChunk when nothing was spilled, else from mMerger
+   int mOutPos;
+   Reader *mReaders;
+   Merger *mMerger;
+
+public:
+   // memoryRecords is about how many records to keep in memory at once.
+   // temporary runs are named tempPrefix + an id; use a prefix that is
+   // unique per process if several processes share a directory
+   FHexternalSort(int memoryRecords, const string & tempPrefix = "FHsortRun",
+      int numThreads = 0, Compare less = Compare(),
+      const RecordIO & io = RecordIO());
+   ~FHexternalSort();
+
+   void add(const Comparable & x);
+   int addFile(const string & fileName);
+   void finish();
+   bool next(Comparable & x);
+   bool writeTo(const string & fileName);
+
+   // sorts the record file inFile into outFile
+   static bool sortFile(const string & inFile, const string & outFile,
+      int memoryRecords, const string & tempPrefix = "FHsortRun",
+      int numThreads = 0, Compare less = Compare(),
+      const RecordIO & io = RecordIO());
+
+   // for exception throwing
+   class FileException { };
+   class NotFinishedException { };      // next() or writeTo() before finish()
+   class AlreadyFinishedException { };  // add() after finish()
+
+private:
+   // owns files and threads - not copyable
+   FHexternalSort(const FHexternalSort & rhs);
+   FHexternalSort & operator=(const FHexternalSort & rhs);
+
+   int chunkSize() const { return mMemoryRecords / 2; }
+   int maxFanIn() const;
+   string tempName();
+   void spill();
+   void mergePass();
+   void openMerge(int first, int count, int blockSize);
+   void closeMerge();
+};
+
+// FHexternalSort method definitions -------------------
+template <class Comparable, class Compare, class RecordIO>
+FHexternalSort<Comparable, Compare, RecordIO>::FHexternalSort(
+   int memoryRecords, const string & tempPrefix, int numThreads,
+   Compare less, const RecordIO & io)
+   : mMemoryRecords(memoryRecords < 4 * MIN_BLOCK ?
+      4 * MIN_BLOCK : memoryRecords),
+   mTempPrefix(tempPrefix), mTempCount(0), mLess(less), mIO(io),
+   mPool(numThreads), mFinished(false), mOutPos(0),
+   mReaders(NULL), mMerger(NULL)
+{
+   mChunk.reserve(chunkSize());
+}
+
+template <class Comparable, class Compare, class RecordIO>
+FHexternalSort<Comparable, Compare, RecordIO>::~FHexternalSort()
+{
+   int k;
+
+   closeMerge();
+   for (k = 0; k < mRuns.size(); k++)
+      remove(mRuns[k].c_str());
+}
+
+// unique among the sorters alive in this process (each removes its own
+// runs when it is destroyed)
+template <class Comparable, class Compare, class RecordIO>
+string FHexternalSort<Comparable, Compare, RecordIO>::tempName()
+{
+   ostringstream name;
+
+   name << mTempPrefix << "_" << hex << (size_t)this << dec << "_"
+      << mTempCount++ << ".tmp";
+   return name.str();
+}
+
+// a merge uses two blocks per run plus two for output, MIN_BLOCK or more
+template <class Comparable, class Compare, class RecordIO>
+int FHexternalSort<Comparable, Compare, RecordIO>::maxFanIn() const
+{
+   int fanIn = mMemoryRecords / (2 * MIN_BLOCK) - 1;
+
+   return fanIn < 2 ? 2 : fanIn;
+}
+
+template <class Comparable, class Compare, class RecordIO>
+void FHexternalSort<Comparable, Compare, RecordIO>::add(const Comparable & x)
+{
+   if (mFinished)
+      throw AlreadyFinishedException();
+   mChunk.push_back(x);
+   if (mChunk.size() >= chunkSize())
+      spill();
+}
+
+// adds every record of a record file; returns how many
+template <class Comparable, class Compare, class RecordIO>
+int FHexternalSort<Comparable, Compare, RecordIO>::addFile(
+   const string & fileName)
+{
+   Reader in;
+   int count;
+
+   if (!in.open(fileName, MIN_BLOCK, mIO))
+      throw FileException();
+   for (count = 0; !in.empty(); in.advance(), count++)
+      add(in.front());
+   return count;
+}
+
+// sorts the chunk in memory and writes it out as the next run
+template <class Comparable, class Compare, class RecordIO>
+void FHexternalSort<Comparable, Compare, RecordIO>::spill()
+{
+   FHrunWriter<Comparable, RecordIO> out;
+   string name = tempName();
+   int k;
+
+   parallelMergeSort(mChunk, mPool, mLess);
+   if (!out.open(name, MIN_BLOCK, mIO))
+      throw FileException();
+   mRuns.push_back(name);
+   for (k = 0; k < mChunk.size(); k++)
+      out.put(mChunk[k]);
+   if (!out.close())
+      throw FileException();
+   mChunk.resize(0);
+}
+
+// done adding: merges runs down to what one final merge can take
+template <class Comparable, class Compare, class RecordIO>
+void FHexternalSort<Comparable, Compare, RecordIO>::finish()
+{
+   int numRuns;
+
+   if (mFinished)
+      return;
+   mFinished = true;
+
+   // it all fit in memory: no files at all
+   if (mRuns.size() == 0)
+   {
+      parallelMergeSort(mChunk, mPool, mLess);
+      mOutPos = 0;
+      return;
+   }
+
+   if (mChunk.size() > 0)
+      spill();
+   mChunk.clear();
+
+   while (mRuns.size() > maxFanIn())
+      mergePass();
+   numRuns = mRuns.size();
+   openMerge(0, numRuns, mMemoryRecords / (2 * (numRuns + 1)));
+}
+
+// merges each group of maxFanIn consecutive runs into one new run.
+// groups stay in input order, so the sort stays stable
+template <class Comparable, class Compare, class RecordIO>
+void FHexternalSort<Comparable, Compare, RecordIO>::mergePass()
+{
+   FHvector<string> merged;
+   FHrunWriter<Comparable, RecordIO> out;
+   int first, count, k, fanIn = maxFanIn();
+   int blockSize = mMemoryRecords / (2 * (fanIn + 1));
+
+   try
+   {
+      for (first = 0; first < mRuns.size(); first += fanIn)
+      {
+         count = mRuns.size() - first < fanIn ? mRuns.size() - first : fanIn;
+         if (count == 1)
+         {
+            merged.push_back(mRuns[first]);
+            continue;
+         }
+
+         merged.push_back( tempName() );
+         if (!out.open(merged.back(), blockSize, mIO))
+            throw FileException();
+         openMerge(first, count, blockSize);
+         for ( ; !mMerger->empty(); mMerger->advance())
+            out.put(mMerger->top());
+         closeMerge();
+         if (!out.close())
+            throw FileException();
+         for (k = first; k < first + count; k++)
+            remove(mRuns[k].c_str());
+      }
+   }
+   catch (...)
+   {
+      // the new runs, finished or not, aren't in mRuns for the destructor
+      // to remove.  only the last group can be a single old run, and
+      // nothing throws after it, so everything in merged is new
+      closeMerge();
+      try
+      {
+         out.close();   // may fail again on the same bad file
+      }
+      catch (...) { }
+      for (k = 0; k < merged.size(); k++)
+         remove(merged[k].c_str());
+      throw;
+   }
+   mRuns = merged;
+}
+
+template <class Comparable, class Compare, class RecordIO>
+void FHexternalSort<Comparable, Compare, RecordIO>::openMerge(int first,
+   int count, int blockSize)
+{
+   int k;
+
+   closeMerge();
+   mReaders = new Reader[count];
+   for (k = 0; k < count; k++)
+      if (!mReaders[k].open(mRuns[first + k], blockSize, mIO))
+      {
+         closeMerge();
+         throw FileException();
+      }
+   mMerger = new Merger(mReaders, count, mLess);
+}
+
+template <class Comparable, class Compare, class RecordIO>
+void FHexternalSort<Comparable, Compare, RecordIO>::closeMerge()
+{
+   delete mMerger;
+   delete[] mReaders;
+   mMerger = NULL;
+   mReaders = NULL;
+}
+
+// streams the sorted records, in order; false when they are used up
+template <class Comparable, class Compare, class RecordIO>
+bool FHexternalSort<Comparable, Compare, RecordIO>::next(Comparable & x)
+{
+   if (!mFinished)
+      throw NotFinishedException();
+   if (mMerger == NULL)
+   {
+      if (mOutPos >= mChunk.size())
+         return false;
+      x = mChunk[mOutPos++];
+      return true;
+   }
+   return mMerger->next(x);
+}
+
+// writes the rest of the sorted stream to a record file
+template <class Comparable, class Compare, class RecordIO>
+bool FHexternalSort<Comparable, Compare, RecordIO>::writeTo(
+   const string & fileName)
+{
+   FHrunWriter<Comparable, RecordIO> out;
+   int blockSize = mMemoryRecords / (2 * (mRuns.size() + 1));
+
+   if (!mFinished)
+      throw NotFinishedException();
+   if (!out.open(fileName, blockSize, mIO))
+      return false;
+   if (mMerger == NULL)
+      for ( ; mOutPos < mChunk.size(); mOutPos++)
+         out.put(mChunk[mOutPos]);
+   else
+      for ( ; !mMerger->empty(); mMerger->advance())
+         out.put(mMerger->top());
+   return out.close();
+}
+
+template <class Comparable, class Compare, class RecordIO>
+bool FHexternalSort<Comparable, Compare, RecordIO>::sortFile(
+   const string & inFile, const string & outFile, int memoryRecords,
+   const string & tempPrefix, int numThreads, Compare less,
+   const RecordIO & io)
+{
+   FHexternalSort<Comparable, Compare, RecordIO>
+      sorter(memoryRecords, tempPrefix, numThreads, less, io);
+
+   try
+   {
+      sorter.addFile(inFile);
+      sorter.finish();
+   }
+   catch (FileException)
+   {
+      return false;
+   }
+   return sorter.writeTo(outFile);
+}
+
+#endif
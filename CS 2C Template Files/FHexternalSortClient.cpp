@@ -0,0 +1,79 @@
+// Client for FHexternalSort: sorts the EBookEntry catalog by title with
+// far less memory than the catalog needs, so the records go through run
+// files (written and read by EBookEntryIO) and a multi-pass merge.  The
+// sorted stream is checked against the same catalog sorted in memory.
+// Needs catalog-short4.txt (see CS_2C_Client_Support/EBookEntry Folder).
+// Build with threads enabled, e.g.
+//    g++ -std=c++11 -O2 -pthread FHexternalSortClient.cpp EBookEntry.cpp
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+using namespace std;
+
+#include "EBookEntry.h"
+#include "FHexternalSort.h"
+
+#define CATALOG_COPIES 8       // the catalog is added this many times
+#define MEMORY_RECORDS 4096    // records the sorter keeps in memory
+#define NUM_TO_SHOW 10
+
+typedef FHexternalSort<EBookEntry, EBookEntry::ByTitle, EBookEntryIO>
+   BookSorter;
+
+// --------------- main ---------------
+int main()
+{
+   int k, copy, numRecords, numBooks, numWrong;
+   EBookEntryReader bookInput("catalog-short4.txt");
+   FHvector<EBookEntry> inMemory;
+   EBookEntry book;
+   clock_t startTime, stopTime;
+
+   if (bookInput.readError())
+   {
+      cout << "couldn't open " << bookInput.getFileName() << " for input.\n";
+      exit(1);
+   }
+   numBooks = bookInput.getNumBooks();
+   cout << bookInput.getFileName() << ": " << numBooks << " books, added "
+      << CATALOG_COPIES << " times" << endl;
+
+   BookSorter sorter(MEMORY_RECORDS, "FHbookRun");
+   startTime = clock();
+   for (copy = 0; copy < CATALOG_COPIES; copy++)
+      for (k = 0; k < numBooks; k++)
+      {
+         sorter.add(bookInput[k]);
+         inMemory.push_back(bookInput[k]);
+      }
+   sorter.finish();
+
+   // stable, like mergeSort: ties (the copies) come out in the same order
+   mergeSort(inMemory, EBookEntry::ByTitle());
+   for (numRecords = numWrong = 0; sorter.next(book); numRecords++)
+   {
+      if (numRecords < NUM_TO_SHOW)
+         cout << "   #" << book.getETextNum() << "  "
+            << book.getTitle().substr(0, 60) << endl;
+      if (numRecords >= inMemory.size()
+         || book.getETextNum() != inMemory[numRecords].getETextNum())
+         numWrong++;
+   }
+   stopTime = clock();
+
+   cout << numRecords << " records sorted, " << numWrong
+      << " out of place, in "
+      << (double)(stopTime - startTime)/(double)CLOCKS_PER_SEC
+      << " seconds." << endl;
+
+   // the sorter is done taking records
+   try
+   {
+      sorter.add(book);
+   }
+   catch (BookSorter::AlreadyFinishedException)
+   {
+      cout << "add() after finish(): AlreadyFinishedException" << endl;
+   }
+   return 0;
+}
@@ -11,6 +11,7 @@
 #include <stack>
 #include <iostream>
 #include <functional>
+#include "FHindexedHeap.h"
 using namespace std;
 
 // CostType is some numeric type that expresses cost of edges
@@ -35,6 +36,7 @@ public:
    Object data;
    CostType dist;
    VertPtr nextInPath;  // used for client-specific info
+   int heapHandle;      // dijkstra's FHindexedHeap handle for this vertex
 
    FHvertex( const Object & x = Object() );
 
@@ -43,6 +45,20 @@ public:
    const FHvertex<Object, CostType> & operator=
       ( const FHvertex<Object, CostType> & rhs);
    void showAdjList();
+
+   // comparators that don't depend on nSortKey (see FHcompare.h)
+   class ByData
+   {
+   public:
+      bool operator()(const FHvertex & a, const FHvertex & b) const
+         { return a.data < b.data; }
+   };
+   class ByDist
+   {
+   public:
+      bool operator()(const FHvertex & a, const FHvertex & b) const
+         { return a.dist < b.dist; }
+   };
 };
 
 // static const initializations for Vertex --------------
@@ -71,7 +87,7 @@ bool FHvertex<Object, CostType>::setNSortType( int whichType )
 template <class Object, typename CostType>
 FHvertex<Object, CostType>::FHvertex( const Object & x) 
    : data(x), dist((CostType)INFINITY_FH),
-   nextInPath(NULL)
+   nextInPath(NULL), heapHandle(-1)
 {
    // nothing to do
 }
@@ -106,6 +122,7 @@ const FHvertex<Object, CostType> & FHvertex<Object, CostType>::operator=(
    data = rhs.data;
    dist = rhs.dist;
    nextInPath = rhs.nextInPath;;
+   heapHandle = rhs.heapHandle;
    return *this;
 }
 
@@ -268,28 +285,31 @@ bool FHgraph<Object, CostType>::dijkstra(const Object & x)
    typename EdgePairList::iterator edgePrIter;
    VertPtr wPtr, sPtr, vPtr;
    CostType costVW;
-   queue<VertPtr> partiallyProcessedVerts;
+   vector<VertPtr> handleToVert;
 
    sPtr = getVertexWithThisData(x);
    if (sPtr == NULL)
       return false;
 
-   // initialize the vertex list and place the starting vert in p_p_v queue
+   // initialize the vertex list and give each vert a heap handle
    for (vIter = vertPtrSet.begin(); vIter != vertPtrSet.end(); ++vIter)
    {
       (*vIter)->dist = Vertex::INFINITY_FH;
       (*vIter)->nextInPath = NULL;
+      (*vIter)->heapHandle = handleToVert.size();
+      handleToVert.push_back(*vIter);
    }
-   
+
+   // p_p_v heap holds each vertex at most once, keyed on its dist
+   FHindexedHeap<CostType> partiallyProcessedVerts(handleToVert.size());
    sPtr->dist = 0;
-   partiallyProcessedVerts.push( sPtr ); // or, FHbinHeap::insert(), e.g.
+   partiallyProcessedVerts.insert( sPtr->heapHandle, sPtr->dist );
 
    // outer dijkstra loop
    while( !partiallyProcessedVerts.empty() )
    {
-      vPtr = partiallyProcessedVerts.front(); 
-      partiallyProcessedVerts.pop();
-      
+      vPtr = handleToVert[ partiallyProcessedVerts.pop() ];
+
       // inner dijkstra loop: for each vert adj to v, lower its dist to s if you can
       for (edgePrIter = vPtr->adjList.begin(); 
          edgePrIter != vPtr->adjList.end();
@@ -301,9 +321,13 @@ bool FHgraph<Object, CostType>::dijkstra(const Object & x)
          {
             wPtr->dist = vPtr->dist + costVW;
             wPtr->nextInPath = vPtr; 
-            
-            // *wPtr now has improved distance, so add wPtr to p_p_v queue
-            partiallyProcessedVerts.push(wPtr); 
+
+            // *wPtr now has improved distance: lower its key in place
+            if (partiallyProcessedVerts.contains(wPtr->heapHandle))
+               partiallyProcessedVerts.decreaseKey(wPtr->heapHandle,
+                  wPtr->dist);
+            else
+               partiallyProcessedVerts.insert(wPtr->heapHandle, wPtr->dist);
          }
       }
     }
@@ -5,8 +5,40 @@
 #define FHHASHQP_H
 #include "FHvector.h"
 #include <cmath>
+#include <fstream>
+#include <string>
+#include <type_traits>
 using namespace std;
 
+// ---------------------- FHhashQP snapshot image -------------------------
+// layout of the file written by FHhashQP::writeSnapshot() and mapped by
+// FHhashQPSnapshot (FHhashQPSnapshot.h):
+//    FHhashQPImageHeader
+//    unsigned char state[tableSize]   (ACTIVE, EMPTY or DELETED)
+//    Object data[tableSize]           (starting at dataOffset)
+// the image is a raw copy of the table, so it is only valid for trivially
+// copyable Objects, the same Hash() function and the same byte order.
+struct FHhashQPImageHeader
+{
+   static const unsigned int VERSION = 1;
+   static const unsigned int BYTE_ORDER_MARK = 0x01020304;
+   static const int DATA_ALIGN = 16;
+
+   char magic[4];       // "FHQP"
+   unsigned int version;
+   unsigned int byteOrder;
+   unsigned int objectSize;
+   long long tableSize;
+   long long size;
+   long long dataOffset;
+
+   static long long computeDataOffset(long long tableSize)
+   {
+      long long offset = sizeof(FHhashQPImageHeader) + tableSize;
+      return (offset + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+   }
+};
+
 // ---------------------- FHhashQP Prototype --------------------------
 template <class Object>
 class FHhashQP
@@ -33,6 +65,7 @@ public:
    static long nextPrime(long n);
    int size() const { return mSize; }
    bool setMaxLambda( float lm ); 
+   bool writeSnapshot(const string & fileName) const;
 
 protected:
    void rehash();
@@ -170,6 +203,47 @@ bool FHhashQP<Object>::setMaxLambda(float lam)
    return true;
 }
 
+// writes the table, probe layout intact, so FHhashQPSnapshot can query it
+// in place without rebuilding.  returns false if the file can't be written
+template <class Object>
+bool FHhashQP<Object>::writeSnapshot(const string & fileName) const
+{
+   static_assert(is_trivially_copyable<Object>::value,
+      "FHhashQP snapshots require a trivially copyable Object");
+   FHhashQPImageHeader header;
+   long long k, padding;
+   unsigned char state;
+   char zero = 0;
+
+   ofstream outFile(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+   if (!outFile)
+      return false;
+
+   header.magic[0] = 'F'; header.magic[1] = 'H';
+   header.magic[2] = 'Q'; header.magic[3] = 'P';
+   header.version = FHhashQPImageHeader::VERSION;
+   header.byteOrder = FHhashQPImageHeader::BYTE_ORDER_MARK;
+   header.objectSize = sizeof(Object);
+   header.tableSize = mTableSize;
+   header.size = mSize;
+   header.dataOffset = FHhashQPImageHeader::computeDataOffset(mTableSize);
+   outFile.write((const char *)&header, sizeof(header));
+
+   for (k = 0; k < mTableSize; k++)
+   {
+      state = (unsigned char)mArray[k].state;
+      outFile.write((const char *)&state, 1);
+   }
+   padding = header.dataOffset - (long long)sizeof(header) - mTableSize;
+   for ( ; padding > 0; padding--)
+      outFile.write(&zero, 1);
+
+   for (k = 0; k < mTableSize; k++)
+      outFile.write((const char *)&mArray[k].data, sizeof(Object));
+
+   return (bool)outFile;
+}
+
 template <class Object>
 long FHhashQP<Object>::nextPrime(long n)
 {
@@ -0,0 +1,194 @@
+// File FHhashQPSnapshot.h
+// Template definitions for FHhashQPSnapshot.
+// Read-only view of an FHhashQP image written by FHhashQP::writeSnapshot().
+// The file is memory mapped and queried in place, so opening it costs the
+// same for any table size and processes mapping the same file share pages.
+#ifndef FHHASHQPSNAPSHOT_H
+#define FHHASHQPSNAPSHOT_H
+#include "FHhashQP.h"
+#include <string>
+#include <cstring>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// ---------------------- FHhashQPSnapshot Prototype --------------------------
+template <class Object>
+class FHhashQPSnapshot
+{
+   enum { ACTIVE, EMPTY, DELETED };   // must match FHhashQP::ElementState
+
+private:
+   char *mImage;
+   long long mImageSize;
+   const unsigned char *mStates;
+   const Object *mData;
+   int mSize;
+   int mTableSize;
+
+public:
+   FHhashQPSnapshot() : mImage(NULL), mImageSize(0) { close(); }
+   ~FHhashQPSnapshot() { close(); }
+
+   bool open(const string & fileName);
+   void close();
+   bool isOpen() const { return mImage != NULL; }
+   bool contains(const Object & x) const { return find(x) != NULL; }
+   const Object * find(const Object & x) const;
+   int size() const { return mSize; }
+   int tableSize() const { return mTableSize; }
+
+private:
+   // owns a mapping - not copyable
+   FHhashQPSnapshot(const FHhashQPSnapshot & rhs);
+   FHhashQPSnapshot & operator=(const FHhashQPSnapshot & rhs);
+
+   bool validate() const;
+   int myHash(const Object & x) const;
+};
+
+// FHhashQPSnapshot method definitions -------------------
+template <class Object>
+bool FHhashQPSnapshot<Object>::open(const string & fileName)
+{
+   close();
+
+#ifdef _WIN32
+   ifstream inFile(fileName.c_str(), ios::in | ios::binary | ios::ate);
+   if (!inFile)
+      return false;
+   mImageSize = inFile.tellg();
+   if (mImageSize <= 0)
+      return false;
+   mImage = new char[mImageSize];
+   inFile.seekg(0);
+   if (!inFile.read(mImage, mImageSize))
+   {
+      close();
+      return false;
+   }
+#else
+   struct stat fileStat;
+   void *mapped;
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+
+   if (fd < 0)
+      return false;
+   if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+   {
+      ::close(fd);
+      return false;
+   }
+   mapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   ::close(fd);    // the mapping stays valid after the descriptor is closed
+   if (mapped == MAP_FAILED)
+      return false;
+   mImage = (char *)mapped;
+   mImageSize = fileStat.st_size;
+#endif
+
+   if (!validate())
+   {
+      close();
+      return false;
+   }
+
+   const FHhashQPImageHeader *header = (const FHhashQPImageHeader *)mImage;
+   mTableSize = (int)header->tableSize;
+   mSize = (int)header->size;
+   mStates = (const unsigned char *)(mImage + sizeof(FHhashQPImageHeader));
+   mData = (const Object *)(mImage + header->dataOffset);
+   return true;
+}
+
+template <class Object>
+void FHhashQPSnapshot<Object>::close()
+{
+   if (mImage != NULL)
+   {
+#ifdef _WIN32
+      delete[] mImage;
+#else
+      munmap(mImage, mImageSize);
+#endif
+   }
+   mImage = NULL;
+   mImageSize = 0;
+   mStates = NULL;
+   mData = NULL;
+   mSize = mTableSize = 0;
+}
+
+// rejects images from another version, platform or Object type
+template <class Object>
+bool FHhashQPSnapshot<Object>::validate() const
+{
+   FHhashQPImageHeader header;
+
+   if (mImageSize < (long long)sizeof(header))
+      return false;
+   memcpy(&header, mImage, sizeof(header));
+
+   if (memcmp(header.magic, "FHQP", 4) != 0
+      || header.version != FHhashQPImageHeader::VERSION
+      || header.byteOrder != FHhashQPImageHeader::BYTE_ORDER_MARK
+      || header.objectSize != sizeof(Object)
+      || header.tableSize <= 0 || header.size < 0
+      || header.size >= header.tableSize )
+      return false;
+
+   if (header.dataOffset
+      != FHhashQPImageHeader::computeDataOffset(header.tableSize))
+      return false;
+
+   return header.dataOffset + header.tableSize * (long long)sizeof(Object)
+      <= mImageSize;
+}
+
+template <class Object>
+int FHhashQPSnapshot<Object>::myHash(const Object & x) const
+{
+   int hashVal;
+
+   hashVal = Hash(x) % mTableSize;
+   if(hashVal < 0)
+      hashVal += mTableSize;
+
+   return hashVal;
+}
+
+// same quadratic probe as FHhashQP::findPos(), run against the mapped image.
+// a damaged image may have no EMPTY slot, so give up after mTableSize probes
+template <class Object>
+const Object * FHhashQPSnapshot<Object>::find(const Object & x) const
+{
+   int kthOddNum = 1;
+   int index, probes;
+
+   if (mImage == NULL)
+      return NULL;
+
+   index = myHash(x);
+   for (probes = 0; mStates[index] != EMPTY
+      && mData[index] != x; probes++ )
+   {
+      if (probes == mTableSize)
+         return NULL;
+      index += kthOddNum;  // k squared = (k-1) squared + kth odd #
+      kthOddNum += 2;   // compute next odd #
+      while ( index >= mTableSize )
+         index -= mTableSize;
+   }
+
+   if (mStates[index] != ACTIVE)
+      return NULL;
+   return &mData[index];
+}
+
+#endif
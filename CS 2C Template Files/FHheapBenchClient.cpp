@@ -0,0 +1,213 @@
+// Client for comparing FHbinHeap, FHpairingHeap and FHradixHeap as the
+// priority queue in dijkstra over a random FHgraph
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+// for timing our algorithms
+#include <time.h>
+
+#include "FHgraph.h"
+#include "FHbinHeap.h"
+#include "FHpairingHeap.h"
+#include "FHradixHeap.h"
+
+#define NUM_VERTS 20000
+#define NUM_EDGES 200000
+#define MAX_COST 1000
+
+typedef FHgraph<int, int> Graph;
+typedef FHvertex<int, int> Vertex;
+typedef Vertex * VertPtr;
+typedef map<VertPtr, int> EdgePairList;
+
+// what goes into the heaps: a vertex (by index) and its tentative dist
+class HeapEntry
+{
+public:
+   int dist, vert;
+   HeapEntry(int d = 0, int v = 0) : dist(d), vert(v) { }
+   bool operator<(const HeapEntry & rhs) const { return dist < rhs.dist; }
+};
+
+unsigned long long RadixKey(const HeapEntry & x) { return x.dist; }
+
+// ----------- prototypes -------------
+void buildIndex(const Graph & g, vector<VertPtr> & verts,
+   vector< vector< pair<int, int> > > & adj);
+template <class Heap>
+long long lazyDijkstra(const vector< vector< pair<int, int> > > & adj);
+long long pairingDijkstra(const vector< vector< pair<int, int> > > & adj);
+long long graphDijkstra(Graph & g, const vector<VertPtr> & verts);
+
+// --------------- main ---------------
+int main()
+{
+   int k;
+   Graph g;
+   vector<VertPtr> verts;
+   vector< vector< pair<int, int> > > adj;
+   clock_t startTime, stopTime;
+   long long checkSum;
+
+   srand(1);
+   for (k = 0; k < NUM_EDGES; k++)
+      g.addEdge(rand() % NUM_VERTS, rand() % NUM_VERTS, 1 + rand() % MAX_COST);
+   buildIndex(g, verts, adj);
+   cout << "graph: " << verts.size() << " vertices, "
+      << NUM_EDGES << " edges" << endl << endl;
+
+   startTime = clock();
+   checkSum = graphDijkstra(g, verts);
+   stopTime = clock();
+   cout << "FHgraph::dijkstra (FHindexedHeap): "
+      << (double)(stopTime - startTime)/(double)CLOCKS_PER_SEC
+      << " seconds.  sum of dists: " << checkSum << endl;
+
+   startTime = clock();
+   checkSum = lazyDijkstra< FHbinHeap<HeapEntry> >(adj);
+   stopTime = clock();
+   cout << "FHbinHeap (lazy deletion):         "
+      << (double)(stopTime - startTime)/(double)CLOCKS_PER_SEC
+      << " seconds.  sum of dists: " << checkSum << endl;
+
+   startTime = clock();
+   checkSum = lazyDijkstra< FHbinHeap<HeapEntry, 4> >(adj);
+   stopTime = clock();
+   cout << "FHbinHeap 4-ary (lazy deletion):   "
+      << (double)(stopTime - startTime)/(double)CLOCKS_PER_SEC
+      << " seconds.  sum of dists: " << checkSum << endl;
+
+   startTime = clock();
+   checkSum = pairingDijkstra(adj);
+   stopTime = clock();
+   cout << "FHpairingHeap (decreaseKey):       "
+      << (double)(stopTime - startTime)/(double)CLOCKS_PER_SEC
+      << " seconds.  sum of dists: " << checkSum << endl;
+
+   startTime = clock();
+   checkSum = lazyDijkstra< FHradixHeap<HeapEntry> >(adj);
+   stopTime = clock();
+   cout << "FHradixHeap (lazy deletion):       "
+      << (double)(stopTime - startTime)/(double)CLOCKS_PER_SEC
+      << " seconds.  sum of dists: " << checkSum << endl;
+
+   return 0;
+}
+
+// flattens the graph's adjacency lists to vertex indices so every heap
+// is timed on the same work; vertex 0 of the index is the source
+void buildIndex(const Graph & g, vector<VertPtr> & verts,
+   vector< vector< pair<int, int> > > & adj)
+{
+   set<VertPtr> vertPtrSet = g.getVertPtrSet();
+   set<VertPtr>::iterator vIter;
+   EdgePairList::iterator eIter;
+   map<VertPtr, int> index;
+   int k;
+
+   for (vIter = vertPtrSet.begin(); vIter != vertPtrSet.end(); ++vIter)
+   {
+      index[*vIter] = verts.size();
+      verts.push_back(*vIter);
+   }
+   adj.resize(verts.size());
+   for (k = 0; k < (int)verts.size(); k++)
+      for (eIter = verts[k]->adjList.begin();
+         eIter != verts[k]->adjList.end(); ++eIter)
+         adj[k].push_back( make_pair(index[eIter->first], eIter->second) );
+}
+
+// dijkstra for heaps without decreaseKey: push duplicates, skip stale ones
+template <class Heap>
+long long lazyDijkstra(const vector< vector< pair<int, int> > > & adj)
+{
+   vector<int> dist(adj.size(), Vertex::INFINITY_FH);
+   Heap heap;
+   HeapEntry entry;
+   long long sum = 0;
+   int k, w;
+
+   dist[0] = 0;
+   heap.insert( HeapEntry(0, 0) );
+   while (!heap.empty())
+   {
+      entry = heap.pop();
+      if (entry.dist > dist[entry.vert])
+         continue;
+      for (k = 0; k < (int)adj[entry.vert].size(); k++)
+      {
+         w = adj[entry.vert][k].first;
+         if (entry.dist + adj[entry.vert][k].second < dist[w])
+         {
+            dist[w] = entry.dist + adj[entry.vert][k].second;
+            heap.insert( HeapEntry(dist[w], w) );
+         }
+      }
+   }
+
+   for (k = 0; k < (int)dist.size(); k++)
+      if (dist[k] != Vertex::INFINITY_FH)
+         sum += dist[k];
+   return sum;
+}
+
+long long pairingDijkstra(const vector< vector< pair<int, int> > > & adj)
+{
+   typedef FHpairingHeap<HeapEntry> Heap;
+   vector<int> dist(adj.size(), Vertex::INFINITY_FH);
+   vector<Heap::Position> pos(adj.size(), (Heap::Position)NULL);
+   Heap heap;
+   HeapEntry entry;
+   long long sum = 0;
+   int k, w;
+
+   dist[0] = 0;
+   pos[0] = heap.insert( HeapEntry(0, 0) );
+   while (!heap.empty())
+   {
+      entry = heap.pop();
+      pos[entry.vert] = NULL;
+      for (k = 0; k < (int)adj[entry.vert].size(); k++)
+      {
+         w = adj[entry.vert][k].first;
+         if (entry.dist + adj[entry.vert][k].second < dist[w])
+         {
+            dist[w] = entry.dist + adj[entry.vert][k].second;
+            if (pos[w] != NULL)
+               heap.decreaseKey( pos[w], HeapEntry(dist[w], w) );
+            else
+               pos[w] = heap.insert( HeapEntry(dist[w], w) );
+         }
+      }
+   }
+
+   for (k = 0; k < (int)dist.size(); k++)
+      if (dist[k] != Vertex::INFINITY_FH)
+         sum += dist[k];
+   return sum;
+}
+
+long long graphDijkstra(Graph & g, const vector<VertPtr> & verts)
+{
+   long long sum = 0;
+   int k;
+
+   g.dijkstra(verts[0]->data);
+   for (k = 0; k < (int)verts.size(); k++)
+      if (verts[k]->dist != Vertex::INFINITY_FH)
+         sum += verts[k]->dist;
+   return sum;
+}
+
+/* --------------- Sample Run (g++ -O2) ----------------
+
+graph: 20000 vertices, 200000 edges
+
+FHgraph::dijkstra (FHindexedHeap): 0.049649 seconds.  sum of dists: 20036897
+FHbinHeap (lazy deletion):         0.009345 seconds.  sum of dists: 20036897
+FHbinHeap 4-ary (lazy deletion):   0.008504 seconds.  sum of dists: 20036897
+FHpairingHeap (decreaseKey):       0.014256 seconds.  sum of dists: 20036897
+FHradixHeap (lazy deletion):       0.005116 seconds.  sum of dists: 20036897
+
+------------------------------------------- */
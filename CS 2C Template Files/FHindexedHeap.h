@@ -0,0 +1,218 @@
+// File FHindexedHeap.h
+// Template definitions for FHindexedHeap.
+// Indexed min heap: items are small int handles (0, 1, 2, ...) chosen by
+// the client, each with a key.  A position map lets the key of any handle
+// be changed or the handle erased in O(log n), so every handle is in the
+// heap at most once (e.g., one entry per vertex in dijkstra).
+#ifndef FHINDEXEDHEAP_H
+#define FHINDEXEDHEAP_H
+#include "FHvector.h"
+#include <utility>
+using namespace std;
+
+// ---------------------- FHindexedHeap Prototype --------------------------
+template <class Key>
+class FHindexedHeap
+{
+   static const int NOT_IN_HEAP = -1;
+
+private:
+   FHvector<int> mHeap;   // mHeap[k] = handle at heap position k
+   FHvector<int> mPos;    // mPos[handle] = heap position, or NOT_IN_HEAP
+   FHvector<Key> mKeys;   // mKeys[handle] = current key of handle
+   int mSize;
+
+public:
+   FHindexedHeap(int numHandles = 0);
+   bool empty() const { return mSize == 0; }
+   int size() const { return mSize; }
+   void makeEmpty();
+   void reserveHandles(int numHandles);
+
+   bool contains(int handle) const;
+   void insert(int handle, const Key & key);
+   const Key & key(int handle) const;
+   void changeKey(int handle, const Key & key);
+   void decreaseKey(int handle, const Key & key);
+   void increaseKey(int handle, const Key & key);
+   void erase(int handle);
+
+   int top() const;
+   const Key & topKey() const { return mKeys[top()]; }
+   int pop();
+
+   // for exception throwing
+   class HeapEmptyException { };
+   class HandleException { };
+   class KeyChangeException { };
+
+private:
+   void place(int handle, int pos) { mHeap[pos] = handle; mPos[handle] = pos; }
+   void percolateUp(int pos);
+   void percolateDown(int pos);
+   void checkHandle(int handle) const;
+};
+
+// FHindexedHeap method definitions -------------------
+template <class Key>
+FHindexedHeap<Key>::FHindexedHeap(int numHandles) : mSize(0)
+{
+   reserveHandles(numHandles);
+}
+
+// handles must be in [0, numHandles); the map grows on demand in insert()
+template <class Key>
+void FHindexedHeap<Key>::reserveHandles(int numHandles)
+{
+   int k, oldSize = mPos.size();
+
+   if (numHandles <= oldSize)
+      return;
+   mHeap.resize(numHandles);
+   mPos.resize(numHandles);
+   mKeys.resize(numHandles);
+   for (k = oldSize; k < numHandles; k++)
+      mPos[k] = NOT_IN_HEAP;
+}
+
+template <class Key>
+void FHindexedHeap<Key>::makeEmpty()
+{
+   int k;
+
+   for (k = 0; k < mSize; k++)
+      mPos[mHeap[k]] = NOT_IN_HEAP;
+   mSize = 0;
+}
+
+template <class Key>
+void FHindexedHeap<Key>::checkHandle(int handle) const
+{
+   if (handle < 0 || handle >= mPos.size() || mPos[handle] == NOT_IN_HEAP)
+      throw HandleException();
+}
+
+template <class Key>
+bool FHindexedHeap<Key>::contains(int handle) const
+{
+   return handle >= 0 && handle < mPos.size()
+      && mPos[handle] != NOT_IN_HEAP;
+}
+
+template <class Key>
+void FHindexedHeap<Key>::insert(int handle, const Key & key)
+{
+   if (handle < 0 || contains(handle))
+      throw HandleException();
+   if (handle >= mPos.size())
+      reserveHandles(2 * handle + 1);
+
+   mKeys[handle] = key;
+   place(handle, mSize++);
+   percolateUp(mSize - 1);
+}
+
+template <class Key>
+const Key & FHindexedHeap<Key>::key(int handle) const
+{
+   checkHandle(handle);
+   return mKeys[handle];
+}
+
+template <class Key>
+void FHindexedHeap<Key>::changeKey(int handle, const Key & key)
+{
+   checkHandle(handle);
+   if (key < mKeys[handle])
+      decreaseKey(handle, key);
+   else
+      increaseKey(handle, key);
+}
+
+template <class Key>
+void FHindexedHeap<Key>::decreaseKey(int handle, const Key & key)
+{
+   checkHandle(handle);
+   if (mKeys[handle] < key)
+      throw KeyChangeException();
+   mKeys[handle] = key;
+   percolateUp(mPos[handle]);
+}
+
+template <class Key>
+void FHindexedHeap<Key>::increaseKey(int handle, const Key & key)
+{
+   checkHandle(handle);
+   if (key < mKeys[handle])
+      throw KeyChangeException();
+   mKeys[handle] = key;
+   percolateDown(mPos[handle]);
+}
+
+template <class Key>
+void FHindexedHeap<Key>::erase(int handle)
+{
+   int pos, moved;
+
+   checkHandle(handle);
+   pos = mPos[handle];
+   mPos[handle] = NOT_IN_HEAP;
+   if (pos == --mSize)
+      return;
+
+   // move the last item into the hole; it may need to go either way
+   moved = mHeap[mSize];
+   place(moved, pos);
+   percolateUp(pos);
+   percolateDown(mPos[moved]);
+}
+
+template <class Key>
+int FHindexedHeap<Key>::top() const
+{
+   if (empty())
+      throw HeapEmptyException();
+   return mHeap[0];
+}
+
+template <class Key>
+int FHindexedHeap<Key>::pop()
+{
+   int minHandle = top();
+
+   erase(minHandle);
+   return minHandle;
+}
+
+template <class Key>
+void FHindexedHeap<Key>::percolateUp(int pos)
+{
+   int handle = mHeap[pos];
+   const Key & k = mKeys[handle];
+
+   for( ; pos > 0 && k < mKeys[mHeap[(pos - 1) / 2]]; pos = (pos - 1) / 2 )
+      place(mHeap[(pos - 1) / 2], pos);
+   place(handle, pos);
+}
+
+template <class Key>
+void FHindexedHeap<Key>::percolateDown(int pos)
+{
+   int child, handle = mHeap[pos];
+   const Key & k = mKeys[handle];
+
+   for( ; 2 * pos + 1 < mSize; pos = child )
+   {
+      child = 2 * pos + 1;
+      // if 2 children, get the lesser of the two
+      if( child + 1 < mSize && mKeys[mHeap[child + 1]] < mKeys[mHeap[child]] )
+         child++;
+      if( mKeys[mHeap[child]] < k )
+         place(mHeap[child], pos);
+      else
+         break;
+   }
+   place(handle, pos);
+}
+
+#endif
@@ -0,0 +1,191 @@
+// File FHkWayMerge.h
+// Template definitions for FHkWayMerge.
+// Merges k sorted runs with a loser tree: each output element costs about
+// log2(k) comparisons, and only the current front element of each run is
+// looked at, so runs can be streamed (from memory, files, ...).  Ties go to
+// the lower numbered run, so merging runs in their original order is stable.
+//
+// A Run is any class with
+//    bool empty() const;  const Comparable & front() const;  void advance();
+// FHiteratorRun adapts a [begin, end) range of a sorted array or FHvector.
+// Compare is the order the runs are sorted in (see FHcompare.h).
+#ifndef FHKWAYMERGE_H
+#define FHKWAYMERGE_H
+#include "FHvector.h"
+#include "FHcompare.h"
+#include <iterator>
+using namespace std;
+
+// ---------------------- FHiteratorRun Prototype --------------------------
+template <typename Iterator>
+class FHiteratorRun
+{
+private:
+   Iterator mCur, mEnd;
+
+public:
+   FHiteratorRun() { }
+   FHiteratorRun(Iterator begin, Iterator end) : mCur(begin), mEnd(end) { }
+   bool empty() const { return mCur == mEnd; }
+   const typename iterator_traits<Iterator>::value_type & front() const
+      { return *mCur; }
+   void advance() { ++mCur; }
+};
+
+// ---------------------- FHkWayMerge Prototype --------------------------
+template <class Comparable, class Run, class Compare = FHless<Comparable> >
+class FHkWayMerge
+{
+private:
+   Run *mRuns;             // client's runs; they advance as we merge
+   int mNumRuns;
+   FHvector<int> mTree;    // mTree[0] = winning run, mTree[1..] = losers
+   Compare mLess;
+
+public:
+   FHkWayMerge(Run *runs, int numRuns, Compare less = Compare());
+   bool empty() const { return mNumRuns == 0 || mRuns[mTree[0]].empty(); }
+   const Comparable & top() const;
+   bool next(Comparable & x);
+   void advance();
+
+   // for exception throwing
+   class MergeEmptyException { };
+
+private:
+   bool beats(int a, int b) const;
+};
+
+// FHkWayMerge method definitions -------------------
+template <class Comparable, class Run, class Compare>
+FHkWayMerge<Comparable, Run, Compare>::FHkWayMerge(Run *runs, int numRuns,
+   Compare less)
+   : mRuns(runs), mNumRuns(numRuns < 0 ? 0 : numRuns), mLess(less)
+{
+   int k, a, b;
+   FHvector<int> winners(2 * mNumRuns);
+
+   if (mNumRuns == 0)
+      return;
+
+   // runs are the leaves k .. 2k-1; play every match once, bottom up
+   mTree.resize(mNumRuns);
+   for (k = 0; k < mNumRuns; k++)
+      winners[mNumRuns + k] = k;
+   for (k = mNumRuns - 1; k > 0; k--)
+   {
+      a = winners[2 * k];
+      b = winners[2 * k + 1];
+      winners[k] = beats(a, b) ? a : b;
+      mTree[k] = beats(a, b) ? b : a;
+   }
+   mTree[0] = winners[1];
+}
+
+// an empty run loses to anything; equal fronts go to the lower run
+template <class Comparable, class Run, class Compare>
+bool FHkWayMerge<Comparable, Run, Compare>::beats(int a, int b) const
+{
+   if (mRuns[a].empty())
+      return false;
+   if (mRuns[b].empty())
+      return true;
+   if (mLess(mRuns[b].front(), mRuns[a].front()))
+      return false;
+   if (mLess(mRuns[a].front(), mRuns[b].front()))
+      return true;
+   return a < b;
+}
+
+template <class Comparable, class Run, class Compare>
+const Comparable & FHkWayMerge<Comparable, Run, Compare>::top() const
+{
+   if (empty())
+      throw MergeEmptyException();
+   return mRuns[mTree[0]].front();
+}
+
+// advances the winning run and replays its path to the root
+template <class Comparable, class Run, class Compare>
+void FHkWayMerge<Comparable, Run, Compare>::advance()
+{
+   int node, winner, tmp;
+
+   if (empty())
+      throw MergeEmptyException();
+
+   winner = mTree[0];
+   mRuns[winner].advance();
+   for (node = (winner + mNumRuns) / 2; node > 0; node /= 2)
+      if (beats(mTree[node], winner))
+      {
+         tmp = mTree[node];
+         mTree[node] = winner;
+         winner = tmp;
+      }
+   mTree[0] = winner;
+}
+
+// streaming form: copies out the next element, false when all runs are done
+template <class Comparable, class Run, class Compare>
+bool FHkWayMerge<Comparable, Run, Compare>::next(Comparable & x)
+{
+   if (empty())
+      return false;
+   x = top();
+   advance();
+   return true;
+}
+
+// merges the sorted runs a[runStart[k]] ... a[runStart[k+1] - 1] (the last
+// entry of runStart is the end of the last run) into out
+template <typename Iterator, typename OutputIterator,
+   typename Compare = FHless<typename iterator_traits<Iterator>::value_type> >
+OutputIterator kWayMerge(Iterator a, const FHvector<int> & runStart,
+   OutputIterator out, Compare less = Compare())
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int k, numRuns = runStart.size() - 1;
+
+   if (numRuns < 1)
+      return out;
+
+   FHvector< FHiteratorRun<Iterator> > runs(numRuns);
+   for (k = 0; k < numRuns; k++)
+      runs[k] = FHiteratorRun<Iterator>(a + runStart[k], a + runStart[k + 1]);
+
+   FHkWayMerge<Comparable, FHiteratorRun<Iterator>, Compare>
+      merger(&runs[0], numRuns, less);
+   for ( ; !merger.empty(); merger.advance())
+      *out++ = merger.top();
+   return out;
+}
+
+// version that takes a vector of sorted FHvectors
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void kWayMerge(const FHvector< FHvector<Comparable> > & sortedRuns,
+   FHvector<Comparable> & result, Compare less = Compare())
+{
+   typedef typename FHvector<Comparable>::const_iterator Iterator;
+   int k, total, numRuns = sortedRuns.size();
+
+   result.resize(0);
+   if (numRuns < 1)
+      return;
+
+   FHvector< FHiteratorRun<Iterator> > runs(numRuns);
+   for (k = total = 0; k < numRuns; k++)
+   {
+      runs[k] = FHiteratorRun<Iterator>(sortedRuns[k].begin(),
+         sortedRuns[k].end());
+      total += sortedRuns[k].size();
+   }
+   result.reserve(total);
+
+   FHkWayMerge<Comparable, FHiteratorRun<Iterator>, Compare>
+      merger(&runs[0], numRuns, less);
+   for ( ; !merger.empty(); merger.advance())
+      result.push_back(merger.top());
+}
+
+#endif
@@ -0,0 +1,235 @@
+// File FHminMaxHeap.h
+// Template definitions for FHminMaxHeap.
+// Min-max heap (double-ended priority queue) in one FHvector: levels
+// alternate min, max, min, ...  starting at the root, so the min is at the
+// root and the max is one of its children.  findMin/findMax are O(1),
+// removeMin/removeMax and insert are O(log n).  keepLargest/keepSmallest
+// maintain a bounded best-k buffer in the same structure.
+#ifndef FHMINMAXHEAP_H
+#define FHMINMAXHEAP_H
+#include "FHvector.h"
+#include <utility>
+using namespace std;
+
+// ---------------------- FHminMaxHeap Prototype --------------------------
+template <class Comparable>
+class FHminMaxHeap
+{
+private:
+   FHvector<Comparable> mArray;
+
+public:
+   FHminMaxHeap() { }
+   FHminMaxHeap(const FHvector<Comparable> & items);
+   bool empty() const { return mArray.size() == 0; }
+   int size() const { return mArray.size(); }
+   void makeEmpty() { mArray.resize(0); }
+   void insert(const Comparable & x);
+   const Comparable & findMin() const;
+   const Comparable & findMax() const;
+   Comparable removeMin();
+   Comparable removeMax();
+
+   // bounded buffers: hold at most maxSize items, dropping the loser
+   void keepLargest(const Comparable & x, int maxSize);
+   void keepSmallest(const Comparable & x, int maxSize);
+
+   // for exception throwing
+   class HeapEmptyException { };
+
+private:
+   int maxIndex() const;
+   Comparable removeAt(int hole);
+   void trickleDown(int hole);
+   void bubbleUp(int hole);
+   static bool isMinLevel(int k);
+
+   // true if mArray[a] belongs above mArray[b] on this kind of level
+   bool better(int a, int b, bool minLevel) const
+   {
+      return minLevel ? mArray[a] < mArray[b] : mArray[b] < mArray[a];
+   }
+   static void swapAt(Comparable & a, Comparable & b)
+   {
+      Comparable tmp = std::move(a);
+      a = std::move(b);
+      b = std::move(tmp);
+   }
+};
+
+// FHminMaxHeap method definitions -------------------
+template <class Comparable>
+FHminMaxHeap<Comparable>::FHminMaxHeap(const FHvector<Comparable> & items)
+   : mArray(items)
+{
+   int k;
+
+   // order the heap bottom up, as FHbinHeap does
+   for (k = mArray.size() / 2 - 1; k >= 0; k--)
+      trickleDown(k);
+}
+
+// root is level 0 (a min level); levels alternate from there
+template <class Comparable>
+bool FHminMaxHeap<Comparable>::isMinLevel(int k)
+{
+   int level = 0;
+
+   for (k++; k > 1; k >>= 1)
+      level++;
+   return level % 2 == 0;
+}
+
+template <class Comparable>
+const Comparable & FHminMaxHeap<Comparable>::findMin() const
+{
+   if (empty())
+      throw HeapEmptyException();
+   return mArray[0];
+}
+
+template <class Comparable>
+int FHminMaxHeap<Comparable>::maxIndex() const
+{
+   if (mArray.size() == 1)
+      return 0;
+   if (mArray.size() == 2 || mArray[2] < mArray[1])
+      return 1;
+   return 2;
+}
+
+template <class Comparable>
+const Comparable & FHminMaxHeap<Comparable>::findMax() const
+{
+   if (empty())
+      throw HeapEmptyException();
+   return mArray[maxIndex()];
+}
+
+template <class Comparable>
+void FHminMaxHeap<Comparable>::insert(const Comparable & x)
+{
+   mArray.push_back(x);
+   bubbleUp(mArray.size() - 1);
+}
+
+template <class Comparable>
+Comparable FHminMaxHeap<Comparable>::removeMin()
+{
+   if (empty())
+      throw HeapEmptyException();
+   return removeAt(0);
+}
+
+template <class Comparable>
+Comparable FHminMaxHeap<Comparable>::removeMax()
+{
+   if (empty())
+      throw HeapEmptyException();
+   return removeAt(maxIndex());
+}
+
+template <class Comparable>
+void FHminMaxHeap<Comparable>::keepLargest(const Comparable & x, int maxSize)
+{
+   if (maxSize <= 0)
+      return;
+   if (size() < maxSize)
+      insert(x);
+   else if (mArray[0] < x)
+   {
+      removeAt(0);
+      insert(x);
+   }
+}
+
+template <class Comparable>
+void FHminMaxHeap<Comparable>::keepSmallest(const Comparable & x, int maxSize)
+{
+   if (maxSize <= 0)
+      return;
+   if (size() < maxSize)
+      insert(x);
+   else if (x < mArray[maxIndex()])
+   {
+      removeAt(maxIndex());
+      insert(x);
+   }
+}
+
+// hole must be the min (0) or the max position
+template <class Comparable>
+Comparable FHminMaxHeap<Comparable>::removeAt(int hole)
+{
+   int last = mArray.size() - 1;
+   Comparable removed = std::move(mArray[hole]);
+
+   if (hole != last)
+      mArray[hole] = std::move(mArray[last]);
+   mArray.pop_back();
+   if (hole < last)
+      trickleDown(hole);
+   return removed;
+}
+
+// moves mArray[hole] down through its children and grandchildren.  on a
+// min level it looks for the smallest descendant, on a max level the largest
+template <class Comparable>
+void FHminMaxHeap<Comparable>::trickleDown(int hole)
+{
+   int k, best, firstChild, lastDesc, arraySize = mArray.size();
+   bool minLevel = isMinLevel(hole);
+
+   while ( (firstChild = 2 * hole + 1) < arraySize )
+   {
+      // best of the (up to 2) children and (up to 4) grandchildren
+      best = firstChild;
+      if (firstChild + 1 < arraySize && better(firstChild + 1, best, minLevel))
+         best = firstChild + 1;
+      lastDesc = 4 * hole + 6 < arraySize ? 4 * hole + 6 : arraySize - 1;
+      for (k = 4 * hole + 3; k <= lastDesc; k++)
+         if (better(k, best, minLevel))
+            best = k;
+
+      if ( !better(best, hole, minLevel) )
+         return;
+      swapAt(mArray[best], mArray[hole]);
+      if (best <= firstChild + 1)
+         return;   // child: one level down, done
+
+      // grandchild: it may now be on the wrong side of its own parent
+      k = (best - 1) / 2;
+      if (better(k, best, minLevel))
+         swapAt(mArray[best], mArray[k]);
+      hole = best;
+   }
+}
+
+// moves mArray[hole] up through grandparents on its own kind of level,
+// after first switching to the other kind if it belongs there
+template <class Comparable>
+void FHminMaxHeap<Comparable>::bubbleUp(int hole)
+{
+   int parent, grand;
+   bool minLevel = isMinLevel(hole);
+
+   if (hole == 0)
+      return;
+   parent = (hole - 1) / 2;
+   if (better(parent, hole, minLevel))
+   {
+      swapAt(mArray[hole], mArray[parent]);
+      hole = parent;
+      minLevel = !minLevel;
+   }
+
+   for ( ; hole > 2; hole = grand)
+   {
+      grand = ((hole - 1) / 2 - 1) / 2;
+      if ( !better(hole, grand, minLevel) )
+         break;
+      swapAt(mArray[hole], mArray[grand]);
+   }
+}
+
+#endif
@@ -0,0 +1,169 @@
+// File FHmultiQueue.h
+// Template definitions for FHmultiQueue.
+// Relaxed concurrent priority queue (MultiQueue): numThreads * c
+// independently locked FHbinHeaps.  insert() goes to a random heap;
+// tryPop() looks at two random heaps and pops the better of their tops.
+// Items come out close to, but not exactly in, priority order, and
+// threads rarely wait on each other, so throughput grows with cores
+// instead of serializing on one lock.
+#ifndef FHMULTIQUEUE_H
+#define FHMULTIQUEUE_H
+#include "FHbinHeap.h"
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+using namespace std;
+
+// ---------------------- FHmultiQueue Prototype --------------------------
+template <class Comparable, int ARITY = 2>
+class FHmultiQueue
+{
+   static const int DEFAULT_C = 2;
+
+   // one heap and its lock, padded so neighboring lanes' locks don't
+   // share a cache line
+   class Lane
+   {
+   public:
+      mutex lock;
+      FHbinHeap<Comparable, ARITY> heap;
+      char padding[64];
+   };
+
+private:
+   Lane *mLanes;
+   int mNumLanes;
+   atomic<int> mSize;
+
+public:
+   FHmultiQueue(int numThreads = 0, int c = DEFAULT_C);
+   ~FHmultiQueue() { delete[] mLanes; }
+
+   void insert(const Comparable & x);
+   bool tryPop(Comparable & x);
+   bool empty() const { return mSize.load() == 0; }
+   int size() const { return mSize.load(); }
+   int numLanes() const { return mNumLanes; }
+
+private:
+   // owns its lanes and their locks - not copyable
+   FHmultiQueue(const FHmultiQueue & rhs);
+   FHmultiQueue & operator=(const FHmultiQueue & rhs);
+
+   bool popFromAny(Comparable & x);
+   static unsigned int nextRandom();
+};
+
+// FHmultiQueue method definitions -------------------
+// numThreads = 0 means one per hardware thread
+template <class Comparable, int ARITY>
+FHmultiQueue<Comparable, ARITY>::FHmultiQueue(int numThreads, int c)
+   : mSize(0)
+{
+   if (numThreads <= 0)
+      numThreads = thread::hardware_concurrency();
+   if (numThreads <= 0)
+      numThreads = 1;
+   if (c < 1)
+      c = DEFAULT_C;
+   mNumLanes = numThreads * c;
+   mLanes = new Lane[mNumLanes];
+}
+
+// xorshift, one generator per thread so lanes are picked without sharing
+template <class Comparable, int ARITY>
+unsigned int FHmultiQueue<Comparable, ARITY>::nextRandom()
+{
+   static thread_local unsigned int state = 0;
+
+   if (state == 0)
+      state = (unsigned int)hash<thread::id>()(this_thread::get_id()) | 1;
+   state ^= state << 13;
+   state ^= state >> 17;
+   state ^= state << 5;
+   return state;
+}
+
+template <class Comparable, int ARITY>
+void FHmultiQueue<Comparable, ARITY>::insert(const Comparable & x)
+{
+   Lane *lane;
+
+   // skip lanes another thread holds rather than wait on them
+   do
+      lane = &mLanes[nextRandom() % mNumLanes];
+   while (!lane->lock.try_lock());
+
+   lane->heap.insert(x);
+   mSize++;
+   lane->lock.unlock();
+}
+
+// returns false only once every lane has been seen empty
+template <class Comparable, int ARITY>
+bool FHmultiQueue<Comparable, ARITY>::tryPop(Comparable & x)
+{
+   Lane *first, *second, *best;
+   bool popped;
+   int emptyPicks = 0;
+
+   while (mSize.load() > 0)
+   {
+      first = &mLanes[nextRandom() % mNumLanes];
+      second = &mLanes[nextRandom() % mNumLanes];
+      if (!first->lock.try_lock())
+         continue;
+      if (second != first && !second->lock.try_lock())
+      {
+         first->lock.unlock();
+         continue;
+      }
+
+      // the better of two random tops
+      if (first->heap.empty())
+         best = second;
+      else if (second->heap.empty())
+         best = first;
+      else
+         best = second->heap.top() < first->heap.top() ? second : first;
+
+      popped = !best->heap.empty();
+      if (popped)
+      {
+         x = best->heap.pop();
+         mSize--;
+      }
+      first->lock.unlock();
+      if (second != first)
+         second->lock.unlock();
+
+      if (popped)
+         return true;
+
+      // few items left: stop guessing and sweep the lanes
+      if (++emptyPicks > mNumLanes)
+         return popFromAny(x);
+   }
+   return false;
+}
+
+template <class Comparable, int ARITY>
+bool FHmultiQueue<Comparable, ARITY>::popFromAny(Comparable & x)
+{
+   int k;
+
+   for (k = 0; k < mNumLanes; k++)
+   {
+      lock_guard<mutex> guard(mLanes[k].lock);
+      if (!mLanes[k].heap.empty())
+      {
+         x = mLanes[k].heap.pop();
+         mSize--;
+         return true;
+      }
+   }
+   return false;
+}
+
+#endif
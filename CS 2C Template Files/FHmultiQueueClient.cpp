@@ -0,0 +1,137 @@
+// Client for FHmultiQueue: throughput and rank error against thread count,
+// with one mutex-wrapped FHbinHeap as the exact (rank error 0) baseline.
+// Build with threads enabled, e.g.  g++ -std=c++11 -O2 -pthread
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+#include "FHbinHeap.h"
+#include "FHmultiQueue.h"
+
+#define NUM_ITEMS 2000000
+
+// ----------- prototypes -------------
+template <class Queue>
+double drain(Queue & queue, int numThreads, vector<int> & popOrder);
+void rankError(const vector<int> & popOrder, double & mean, int & worst);
+
+// one lock around one heap, with the same tryPop() as FHmultiQueue
+class LockedHeap
+{
+private:
+   mutex lock;
+   FHbinHeap<int> heap;
+
+public:
+   void insert(int x) { lock_guard<mutex> guard(lock); heap.insert(x); }
+   bool tryPop(int & x)
+   {
+      lock_guard<mutex> guard(lock);
+      if (heap.empty())
+         return false;
+      x = heap.pop();
+      return true;
+   }
+};
+
+// --------------- main ---------------
+int main()
+{
+   int k, numThreads, maxThreads, worst;
+   double seconds, mean;
+   vector<int> keys(NUM_ITEMS), popOrder;
+
+   // keys are a shuffled 0 .. NUM_ITEMS-1, so a key is its own true rank
+   for (k = 0; k < NUM_ITEMS; k++)
+      keys[k] = k;
+   srand(1);
+   for (k = NUM_ITEMS - 1; k > 0; k--)
+      swap(keys[k], keys[rand() % (k + 1)]);
+
+   maxThreads = thread::hardware_concurrency();
+   if (maxThreads < 1)
+      maxThreads = 1;
+
+   cout << "threads  queue          Mpops/s  mean rank err  max rank err"
+      << endl;
+   for (numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+   {
+      LockedHeap locked;
+      for (k = 0; k < NUM_ITEMS; k++)
+         locked.insert(keys[k]);
+      seconds = drain(locked, numThreads, popOrder);
+      rankError(popOrder, mean, worst);
+      cout << setw(7) << numThreads << "  locked heap  " << setw(9)
+         << NUM_ITEMS / seconds / 1e6 << "  " << setw(13) << mean
+         << "  " << setw(12) << worst << endl;
+
+      FHmultiQueue<int> multi(numThreads);
+      for (k = 0; k < NUM_ITEMS; k++)
+         multi.insert(keys[k]);
+      seconds = drain(multi, numThreads, popOrder);
+      rankError(popOrder, mean, worst);
+      cout << setw(7) << numThreads << "  multiQueue   " << setw(9)
+         << NUM_ITEMS / seconds / 1e6 << "  " << setw(13) << mean
+         << "  " << setw(12) << worst << endl;
+   }
+   return 0;
+}
+
+// numThreads workers pop until the queue is empty.  each pop takes a
+// ticket so popOrder approximates the global order items came out in
+template <class Queue>
+double drain(Queue & queue, int numThreads, vector<int> & popOrder)
+{
+   vector<thread> workers;
+   atomic<int> ticket(0);
+   int k;
+
+   popOrder.assign(NUM_ITEMS, 0);
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (k = 0; k < numThreads; k++)
+      workers.push_back( thread([&]()
+      {
+         int x;
+         while (queue.tryPop(x))
+            popOrder[ticket++] = x;
+      }) );
+   for (k = 0; k < numThreads; k++)
+      workers[k].join();
+
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// rank error of a pop = how many smaller keys were still in the queue.
+// a Fenwick tree over the keys counts the ones not yet popped
+void rankError(const vector<int> & popOrder, double & mean, int & worst)
+{
+   vector<int> tree(NUM_ITEMS + 1, 0);
+   long long total = 0;
+   int k, j, err;
+
+   for (k = 1; k <= NUM_ITEMS; k++)
+   {
+      tree[k]++;
+      if (k + (k & -k) <= NUM_ITEMS)
+         tree[k + (k & -k)] += tree[k];
+   }
+
+   worst = 0;
+   for (k = 0; k < NUM_ITEMS; k++)
+   {
+      for (err = 0, j = popOrder[k]; j > 0; j -= j & -j)
+         err += tree[j];
+      for (j = popOrder[k] + 1; j <= NUM_ITEMS; j += j & -j)
+         tree[j]--;
+      total += err;
+      if (err > worst)
+         worst = err;
+   }
+   mean = (double)total / NUM_ITEMS;
+}
@@ -0,0 +1,249 @@
+// File FHpairingHeap.h
+// Template definitions for FHpairingHeap.
+// Pairing heap: O(1) insert and meld, amortized O(log n) remove and
+// (in practice very fast) decreaseKey.  Same insert/top/pop/remove
+// interface as FHbinHeap; insert() also returns a Position that can be
+// handed back to decreaseKey().
+#ifndef FHPAIRINGHEAP_H
+#define FHPAIRINGHEAP_H
+#include "FHvector.h"
+#include <utility>
+using namespace std;
+
+// ---------------------- FHp_heapNode Prototype --------------------------
+template <class Comparable>
+class FHp_heapNode
+{
+public:
+   FHp_heapNode( const Comparable & d = Comparable() )
+      : leftChild(NULL), nextSibling(NULL), prev(NULL), data(d)
+   { }
+
+   // prev is the parent for a leftmost child, else the left sibling
+   FHp_heapNode *leftChild, *nextSibling, *prev;
+   Comparable data;
+};
+
+// ---------------------- FHpairingHeap Prototype --------------------------
+template <class Comparable>
+class FHpairingHeap
+{
+   typedef FHp_heapNode<Comparable> Node;
+
+private:
+   Node *mRoot;
+   int mSize;
+   FHvector<Node *> mTreeArray;   // scratch space for pop()'s two passes
+
+public:
+   typedef Node * Position;
+
+   FHpairingHeap() : mRoot(NULL), mSize(0) { }
+   ~FHpairingHeap() { makeEmpty(); }
+
+   bool empty() const { return mSize == 0; }
+   int size() const { return mSize; }
+   void makeEmpty();
+   Position insert(const Comparable & x);
+   const Comparable & top() const;
+   Comparable pop();
+   Comparable remove() { return pop(); }
+   void decreaseKey(Position p, const Comparable & newVal);
+   void meld(FHpairingHeap & rhs);
+
+   // for exception throwing
+   class HeapEmptyException { };
+   class KeyChangeException { };
+
+private:
+   // node ownership makes a shallow copy unsafe
+   FHpairingHeap(const FHpairingHeap & rhs);
+   FHpairingHeap & operator=(const FHpairingHeap & rhs);
+
+   Node * compareAndLink(Node *first, Node *second);
+   Node * combineSiblings(Node *firstSibling);
+};
+
+// FHpairingHeap method definitions -------------------
+// iterative so a long sibling list can't overflow the stack
+template <class Comparable>
+void FHpairingHeap<Comparable>::makeEmpty()
+{
+   Node *node, *tail, *toDelete = mRoot;
+
+   // nextSibling links a list of nodes still to be freed; each node's
+   // children are spliced onto the front of that list before it goes
+   while (toDelete != NULL)
+   {
+      node = toDelete;
+      toDelete = node->nextSibling;
+      if (node->leftChild != NULL)
+      {
+         for (tail = node->leftChild; tail->nextSibling != NULL;
+            tail = tail->nextSibling)
+            ;
+         tail->nextSibling = toDelete;
+         toDelete = node->leftChild;
+      }
+      delete node;
+   }
+   mRoot = NULL;
+   mSize = 0;
+}
+
+template <class Comparable>
+typename FHpairingHeap<Comparable>::Position
+   FHpairingHeap<Comparable>::insert(const Comparable & x)
+{
+   Node *newNode = new Node(x);
+
+   if (mRoot == NULL)
+      mRoot = newNode;
+   else
+      mRoot = compareAndLink(mRoot, newNode);
+   mSize++;
+   return newNode;
+}
+
+template <class Comparable>
+const Comparable & FHpairingHeap<Comparable>::top() const
+{
+   if (empty())
+      throw HeapEmptyException();
+   return mRoot->data;
+}
+
+template <class Comparable>
+Comparable FHpairingHeap<Comparable>::pop()
+{
+   Node *oldRoot;
+
+   if (empty())
+      throw HeapEmptyException();
+
+   Comparable minObject = std::move(mRoot->data);
+   oldRoot = mRoot;
+   if (mRoot->leftChild == NULL)
+      mRoot = NULL;
+   else
+      mRoot = combineSiblings(mRoot->leftChild);
+   delete oldRoot;
+   mSize--;
+
+   return minObject;
+}
+
+// p must have come from insert() on this heap and still be in it
+template <class Comparable>
+void FHpairingHeap<Comparable>::decreaseKey(Position p,
+   const Comparable & newVal)
+{
+   if (p->data < newVal)
+      throw KeyChangeException();
+   p->data = newVal;
+   if (p == mRoot)
+      return;
+
+   // cut p's subtree out of its sibling list and relink with the root
+   if (p->nextSibling != NULL)
+      p->nextSibling->prev = p->prev;
+   if (p->prev->leftChild == p)
+      p->prev->leftChild = p->nextSibling;
+   else
+      p->prev->nextSibling = p->nextSibling;
+
+   p->nextSibling = NULL;
+   mRoot = compareAndLink(mRoot, p);
+}
+
+// moves all of rhs's items into this heap in O(1); rhs is left empty
+template <class Comparable>
+void FHpairingHeap<Comparable>::meld(FHpairingHeap & rhs)
+{
+   if (&rhs == this || rhs.mRoot == NULL)
+      return;
+
+   if (mRoot == NULL)
+      mRoot = rhs.mRoot;
+   else
+      mRoot = compareAndLink(mRoot, rhs.mRoot);
+   mSize += rhs.mSize;
+   rhs.mRoot = NULL;
+   rhs.mSize = 0;
+}
+
+// links two trees and returns the root of the result.  first and second
+// must be roots with no siblings (every caller detaches them first)
+template <class Comparable>
+FHp_heapNode<Comparable> * FHpairingHeap<Comparable>::compareAndLink(
+   Node *first, Node *second)
+{
+   if (second == NULL)
+      return first;
+
+   if (second->data < first->data)
+   {
+      // second becomes the root; first becomes its leftmost child
+      second->prev = first->prev;
+      first->prev = second;
+      first->nextSibling = second->leftChild;
+      if (first->nextSibling != NULL)
+         first->nextSibling->prev = first;
+      second->leftChild = first;
+      return second;
+   }
+   else
+   {
+      // first stays the root; second becomes its leftmost child
+      second->prev = first;
+      first->nextSibling = second->nextSibling;
+      if (first->nextSibling != NULL)
+         first->nextSibling->prev = first;
+      second->nextSibling = first->leftChild;
+      if (second->nextSibling != NULL)
+         second->nextSibling->prev = second;
+      first->leftChild = second;
+      return first;
+   }
+}
+
+// standard two-pass merge: pair up left to right, then fold right to left
+template <class Comparable>
+FHp_heapNode<Comparable> * FHpairingHeap<Comparable>::combineSiblings(
+   Node *firstSibling)
+{
+   int k, numSiblings;
+
+   if (firstSibling->nextSibling == NULL)
+   {
+      firstSibling->prev = NULL;
+      return firstSibling;
+   }
+
+   // detach each sibling into mTreeArray
+   mTreeArray.resize(0);
+   for ( ; firstSibling != NULL; firstSibling = firstSibling->nextSibling)
+   {
+      mTreeArray.push_back(firstSibling);
+      firstSibling->prev->nextSibling = NULL;  // break links as we go
+   }
+   numSiblings = mTreeArray.size();
+   for (k = 0; k < numSiblings; k++)
+      mTreeArray[k]->prev = NULL;
+
+   // first pass: left to right, merge pairs
+   for (k = 0; k + 1 < numSiblings; k += 2)
+      mTreeArray[k] = compareAndLink(mTreeArray[k], mTreeArray[k + 1]);
+
+   // second pass: right to left, fold the pair winners into the last one
+   k -= 2;
+   if (k == numSiblings - 3)     // odd count: last tree was not paired
+      mTreeArray[k] = compareAndLink(mTreeArray[k], mTreeArray[k + 2]);
+   for ( ; k >= 2; k -= 2)
+      mTreeArray[k - 2] = compareAndLink(mTreeArray[k - 2], mTreeArray[k]);
+
+   mTreeArray[0]->prev = NULL;
+   return mTreeArray[0];
+}
+
+#endif
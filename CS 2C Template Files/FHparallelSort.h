@@ -0,0 +1,377 @@
+// File FHparallelSort.h
+// Template definitions for parallel versions of FHsort.h's mergeSort,
+// quickSort, shellSort and heapSortBottomUp, run on an FHthreadPool.
+// Subproblems above a size cutoff are forked onto the pool; smaller ones
+// go to the serial FHsort.h code.
+// Results are identical to the serial sorts: parallelMergeSort is stable
+// like mergeSort, and parallelQuickSort makes exactly the partitions
+// quickSort makes, just on several threads at once.  An exception thrown
+// by the comparator or a copy propagates to the caller, as it does from
+// the serial sorts (the array is then left in some unsorted order).
+#ifndef FHPARALLELSORT_H
+#define FHPARALLELSORT_H
+#include "FHsort.h"
+#include "FHthreadPool.h"
+
+#define PARALLEL_SORT_CUTOFF 16384   // below this, sort serially
+#define PARALLEL_MERGE_CUTOFF 16384  // below this, merge serially
+#define PARALLEL_SHELL_CHAINS 512    // fewest gap chains per shellSort task
+
+// parallelMerge helpers: first position in src[lo..hi) whose item is not
+// less than x (lower), or is greater than x (upper)
+template <typename Comparable, typename Compare>
+int lowerBoundFH(const FHvector<Comparable> & src, int lo, int hi,
+   const Comparable & x, Compare less)
+{
+   int mid;
+
+   while (lo < hi)
+   {
+      mid = lo + (hi - lo) / 2;
+      if (less(src[mid], x))
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+template <typename Comparable, typename Compare>
+int upperBoundFH(const FHvector<Comparable> & src, int lo, int hi,
+   const Comparable & x, Compare less)
+{
+   int mid;
+
+   while (lo < hi)
+   {
+      mid = lo + (hi - lo) / 2;
+      if (less(x, src[mid]))
+         hi = mid;
+      else
+         lo = mid + 1;
+   }
+   return lo;
+}
+
+// stable merge of src[aLo..aHi) and src[bLo..bHi) into dst starting at
+// dstLo.  the larger input is split at its middle and the other at the
+// matching binary search position, giving two independent smaller merges
+template <typename Comparable, typename Compare>
+void parallelMerge(FHthreadPool & pool, const FHvector<Comparable> & src,
+   int aLo, int aHi, int bLo, int bHi, FHvector<Comparable> & dst, int dstLo,
+   Compare less)
+{
+   int aMid, bMid;
+   FHtaskGroup group;
+   FHtaskGuard guard(pool, group);
+
+   if ( (aHi - aLo) + (bHi - bLo) <= PARALLEL_MERGE_CUTOFF )
+   {
+      // ties go to the a side, which keeps the merge stable
+      while (aLo < aHi && bLo < bHi)
+         if ( !less(src[bLo], src[aLo]) )
+            dst[dstLo++] = src[aLo++];
+         else
+            dst[dstLo++] = src[bLo++];
+      while (aLo < aHi)
+         dst[dstLo++] = src[aLo++];
+      while (bLo < bHi)
+         dst[dstLo++] = src[bLo++];
+      return;
+   }
+
+   // items equal to the split key from a stay left of those from b
+   if (aHi - aLo >= bHi - bLo)
+   {
+      aMid = aLo + (aHi - aLo) / 2;
+      bMid = lowerBoundFH(src, bLo, bHi, src[aMid], less);
+   }
+   else
+   {
+      bMid = bLo + (bHi - bLo) / 2;
+      aMid = upperBoundFH(src, aLo, aHi, src[bMid], less);
+   }
+
+   pool.run(group, [&]()
+   {
+      parallelMerge(pool, src, aLo, aMid, bLo, bMid, dst, dstLo, less);
+   });
+   parallelMerge(pool, src, aMid, aHi, bMid, bHi, dst,
+      dstLo + (aMid - aLo) + (bMid - bLo), less);
+   pool.wait(group);
+}
+
+// copies from[lo..hi) to to[lo..hi) in cutoff-sized pieces
+template <typename Comparable>
+void parallelCopy(FHthreadPool & pool, const FHvector<Comparable> & from,
+   FHvector<Comparable> & to, int lo, int hi)
+{
+   int mid;
+   FHtaskGroup group;
+   FHtaskGuard guard(pool, group);
+
+   if (hi - lo <= PARALLEL_MERGE_CUTOFF)
+   {
+      for ( ; lo < hi; lo++)
+         to[lo] = from[lo];
+      return;
+   }
+
+   mid = lo + (hi - lo) / 2;
+   pool.run(group, [&]() { parallelCopy(pool, from, to, lo, mid); });
+   parallelCopy(pool, from, to, mid, hi);
+   pool.wait(group);
+}
+
+// parallelMergeSort internal: sorts a[lo..hi)
+template <typename Comparable, typename Compare>
+void parallelMergeSort(FHthreadPool & pool, FHvector<Comparable> & a,
+   FHvector<Comparable> & working, int lo, int hi, Compare less)
+{
+   int mid;
+   FHtaskGroup group;
+   FHtaskGuard guard(pool, group);
+
+   if (hi - lo <= PARALLEL_SORT_CUTOFF)
+   {
+      mergeSortBottomUp(a, working, lo, hi - 1, less);
+      return;
+   }
+
+   mid = lo + (hi - lo) / 2;
+   pool.run(group, [&]()
+   {
+      parallelMergeSort(pool, a, working, lo, mid, less);
+   });
+   parallelMergeSort(pool, a, working, mid, hi, less);
+   pool.wait(group);
+
+   parallelMerge(pool, a, lo, mid, mid, hi, working, lo, less);
+   parallelCopy(pool, working, a, lo, hi);
+}
+
+// parallelMergeSort public drivers
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelMergeSort(FHvector<Comparable> & a, FHthreadPool & pool,
+   Compare less = Compare())
+{
+   if (a.size() < 2)
+      return;
+
+   FHvector<Comparable> working(a.size());
+   parallelMergeSort(pool, a, working, 0, a.size(), less);
+}
+
+// numThreads = 0 means one per hardware thread
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelMergeSort(FHvector<Comparable> & a, int numThreads = 0,
+   Compare less = Compare())
+{
+   FHthreadPool pool(numThreads);
+   parallelMergeSort(a, pool, less);
+}
+
+// comparator only, as for the serial sorts:  parallelMergeSort(a, less)
+template <typename Comparable, typename Compare>
+void parallelMergeSort(FHvector<Comparable> & a, Compare less)
+{
+   parallelMergeSort(a, 0, less);
+}
+
+// parallelQuickSort internal: same partitions as quickSort
+template <typename Comparable, typename Compare>
+void parallelQuickSort(FHthreadPool & pool, FHvector<Comparable> & a,
+   int left, int right, Compare less)
+{
+   int i;
+   FHtaskGroup group;
+   FHtaskGuard guard(pool, group);
+
+   if (right - left < PARALLEL_SORT_CUTOFF)
+   {
+      quickSort(a, left, right, less);
+      return;
+   }
+
+   i = quickSortPartition(a, left, right, less);
+   pool.run(group, [&]() { parallelQuickSort(pool, a, left, i - 1, less); });
+   parallelQuickSort(pool, a, i + 1, right, less);
+   pool.wait(group);
+}
+
+// parallelQuickSort public drivers
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelQuickSort(FHvector<Comparable> & a, FHthreadPool & pool,
+   Compare less = Compare())
+{
+   parallelQuickSort(pool, a, 0, a.size() - 1, less);
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelQuickSort(FHvector<Comparable> & a, int numThreads = 0,
+   Compare less = Compare())
+{
+   FHthreadPool pool(numThreads);
+   parallelQuickSort(a, pool, less);
+}
+
+// comparator only, as for the serial sorts:  parallelQuickSort(a, less)
+template <typename Comparable, typename Compare>
+void parallelQuickSort(FHvector<Comparable> & a, Compare less)
+{
+   parallelQuickSort(a, 0, less);
+}
+
+// parallelShellSort pass helper: sorts chains firstChain .. lastChain - 1
+// of the given gap, splitting them among tasks while each half still has
+// PARALLEL_SHELL_CHAINS chains and the pass is worth forking
+template <typename Comparable, typename Compare>
+void parallelGapPass(FHthreadPool & pool, FHvector<Comparable> & a, int gap,
+   int firstChain, int lastChain, Compare less)
+{
+   int midChain, numChains = lastChain - firstChain;
+   FHtaskGroup group;
+   FHtaskGuard guard(pool, group);
+
+   if ( numChains < 2 * PARALLEL_SHELL_CHAINS
+      || (long long)numChains * (a.size() / gap) <= PARALLEL_SORT_CUTOFF )
+   {
+      shellGapPass(a.begin(), a.size(), gap, firstChain, lastChain, less);
+      return;
+   }
+
+   midChain = firstChain + numChains / 2;
+   pool.run(group, [&]()
+   {
+      parallelGapPass(pool, a, gap, firstChain, midChain, less);
+   });
+   parallelGapPass(pool, a, gap, midChain, lastChain, less);
+   pool.wait(group);
+}
+
+// parallelShellSort public drivers.  the items gap apart form gap
+// independent chains, so the large-gap passes run on several threads;
+// passes with fewer than 2 * PARALLEL_SHELL_CHAINS gaps run serially.
+// in place like shellSort: no allocation beyond the pool's tasks
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelShellSort(FHvector<Comparable> & a, FHthreadPool & pool,
+   FHgapSequence gaps = DEFAULT_GAPS, Compare less = Compare())
+{
+   int k, gap;
+
+   for (k = 0; shellGap(gaps, k, a.size()) > 0; k++)
+      ;
+   while (--k >= 0)
+   {
+      gap = shellGap(gaps, k, a.size());
+      parallelGapPass(pool, a, gap, 0, gap, less);
+   }
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelShellSort(FHvector<Comparable> & a, int numThreads = 0,
+   FHgapSequence gaps = DEFAULT_GAPS, Compare less = Compare())
+{
+   FHthreadPool pool(numThreads);
+   parallelShellSort(a, pool, gaps, less);
+}
+
+// no thread count, as for the serial shellSort:  parallelShellSort(a, less)
+// or parallelShellSort(a, gaps, less)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelShellSort(FHvector<Comparable> & a, FHgapSequence gaps,
+   Compare less = Compare())
+{
+   parallelShellSort(a, 0, gaps, less);
+}
+
+template <typename Comparable, typename Compare>
+void parallelShellSort(FHvector<Comparable> & a, Compare less)
+{
+   parallelShellSort(a, 0, DEFAULT_GAPS, less);
+}
+
+// parallelHeapSort helper: makes the subtree under root (of the heap
+// a[0] ... a[arraySize - 1]) a max heap, one level at a time from the
+// bottom up, so each level is a run of neighboring items
+template <typename Comparable, typename Compare>
+void heapifySubtree(FHvector<Comparable> & a, int root, int arraySize,
+   Compare less)
+{
+   int first, last, k, lastParent = arraySize/2 - 1;
+
+   // first ... last: root's descendants on its lowest level (leaves)
+   for (first = last = root; 2 * first + 1 < arraySize; )
+   {
+      first = 2 * first + 1;
+      last = 2 * last + 2;
+   }
+   while (first != root)
+   {
+      first = (first - 1) / 2;
+      last = (last - 2) / 2;
+      for (k = first; k <= last && k <= lastParent; k++)
+         percolateDownBottomUp(a.begin(), k, arraySize, less);
+   }
+}
+
+// the two subtrees under a node are independent heaps, so they are built
+// at the same time, then the node is sifted into them.  subtrees of
+// PARALLEL_SORT_CUTOFF or fewer items are built serially
+template <typename Comparable, typename Compare>
+void parallelHeapify(FHthreadPool & pool, FHvector<Comparable> & a,
+   int root, int arraySize, Compare less)
+{
+   FHtaskGroup group;
+   FHtaskGuard guard(pool, group);
+
+   if (2 * root + 1 >= arraySize)
+      return;
+   if ( arraySize / (root + 1) <= PARALLEL_SORT_CUTOFF )
+   {
+      heapifySubtree(a, root, arraySize, less);
+      return;
+   }
+
+   pool.run(group, [&]()
+   {
+      parallelHeapify(pool, a, 2 * root + 1, arraySize, less);
+   });
+   parallelHeapify(pool, a, 2 * root + 2, arraySize, less);
+   pool.wait(group);
+   percolateDownBottomUp(a.begin(), root, arraySize, less);
+}
+
+// parallelHeapSort public drivers - heapSortBottomUp with the heap built
+// in parallel.  the removals that follow are one after another, so they
+// stay serial.  in place: no allocation beyond the pool's tasks
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelHeapSort(FHvector<Comparable> & a, FHthreadPool & pool,
+   Compare less = Compare())
+{
+   int k;
+
+   parallelHeapify(pool, a, 0, a.size(), less);
+   for (k = a.size() - 1; k > 0; k--)
+   {
+      mySwapFH(a[0], a[k]);
+      percolateDownBottomUp(a.begin(), 0, k, less);
+   }
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void parallelHeapSort(FHvector<Comparable> & a, int numThreads = 0,
+   Compare less = Compare())
+{
+   FHthreadPool pool(numThreads);
+   parallelHeapSort(a, pool, less);
+}
+
+// comparator only, as for the serial sorts:  parallelHeapSort(a, less)
+template <typename Comparable, typename Compare>
+void parallelHeapSort(FHvector<Comparable> & a, Compare less)
+{
+   parallelHeapSort(a, 0, less);
+}
+
+#endif
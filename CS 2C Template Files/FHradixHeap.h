@@ -0,0 +1,141 @@
+// File FHradixHeap.h
+// Template definitions for FHradixHeap.
+// Radix heap for monotone integer keys: each key inserted must be >= the
+// last key removed (true of dijkstra with non-negative costs and of event
+// queues that never schedule into the past).  insert is O(1) and remove is
+// amortized O(log C) for keys spanning a range C, with no comparisons.
+//
+// Same insert/top/pop/remove interface as FHbinHeap.  Like Hash() for the
+// hash tables, the client supplies a function
+//    unsigned long long RadixKey(const Comparable & x)
+// that returns the (non-negative) integer priority of x.
+#ifndef FHRADIXHEAP_H
+#define FHRADIXHEAP_H
+#include "FHvector.h"
+#include <utility>
+using namespace std;
+
+// ---------------------- FHradixHeap Prototype --------------------------
+template <class Comparable>
+class FHradixHeap
+{
+   static const int NUM_BUCKETS = 65;   // bucket k: keys differing from
+                                        // mLast first in bit k-1
+private:
+   mutable FHvector<Comparable> mBuckets[NUM_BUCKETS];
+   mutable unsigned long long mLast;
+   int mSize;
+
+public:
+   FHradixHeap() : mLast(0), mSize(0) { }
+   bool empty() const { return mSize == 0; }
+   int size() const { return mSize; }
+   void makeEmpty();
+   void insert(const Comparable & x);
+   const Comparable & top() const;
+   Comparable pop();
+   Comparable remove() { return pop(); }
+
+   // for exception throwing
+   class HeapEmptyException { };
+   class MonotoneException { };
+
+private:
+   static int bucketFor(unsigned long long key, unsigned long long last);
+   void pull() const;
+};
+
+// FHradixHeap method definitions -------------------
+template <class Comparable>
+void FHradixHeap<Comparable>::makeEmpty()
+{
+   int k;
+
+   for (k = 0; k < NUM_BUCKETS; k++)
+      mBuckets[k].resize(0);
+   mLast = 0;
+   mSize = 0;
+}
+
+// index of the highest bit in which key and last differ, plus one
+template <class Comparable>
+int FHradixHeap<Comparable>::bucketFor(unsigned long long key,
+   unsigned long long last)
+{
+   unsigned long long diff = key ^ last;
+   int bucket = 0;
+
+   if (diff == 0)
+      return 0;
+#if defined(__GNUC__)
+   bucket = 64 - __builtin_clzll(diff);
+#else
+   for ( ; diff != 0; diff >>= 1)
+      bucket++;
+#endif
+   return bucket;
+}
+
+template <class Comparable>
+void FHradixHeap<Comparable>::insert(const Comparable & x)
+{
+   unsigned long long key = RadixKey(x);
+
+   if (key < mLast)
+      throw MonotoneException();
+   mBuckets[bucketFor(key, mLast)].push_back(x);
+   mSize++;
+}
+
+// makes bucket 0 non-empty by redistributing the first non-empty bucket
+// around its minimum.  each item only ever moves to a lower bucket
+template <class Comparable>
+void FHradixHeap<Comparable>::pull() const
+{
+   int k, bucket, bucketSize;
+   unsigned long long key, minKey;
+
+   if (mBuckets[0].size() > 0)
+      return;
+
+   for (bucket = 1; mBuckets[bucket].size() == 0; bucket++)
+      ;
+
+   FHvector<Comparable> & from = mBuckets[bucket];
+   bucketSize = from.size();
+   minKey = RadixKey(from[0]);
+   for (k = 1; k < bucketSize; k++)
+      if ( (key = RadixKey(from[k])) < minKey )
+         minKey = key;
+
+   mLast = minKey;
+   for (k = 0; k < bucketSize; k++)
+      mBuckets[bucketFor(RadixKey(from[k]), mLast)].push_back(from[k]);
+   from.resize(0);
+}
+
+template <class Comparable>
+const Comparable & FHradixHeap<Comparable>::top() const
+{
+   if (empty())
+      throw HeapEmptyException();
+   pull();
+   return mBuckets[0].back();
+}
+
+template <class Comparable>
+Comparable FHradixHeap<Comparable>::pop()
+{
+   if (empty())
+      throw HeapEmptyException();
+   pull();
+
+   FHvector<Comparable> & minBucket = mBuckets[0];
+   Comparable minObject = std::move(minBucket[minBucket.size() - 1]);
+   minBucket.pop_back();
+   mSize--;
+
+   return minObject;
+}
+
+#endif
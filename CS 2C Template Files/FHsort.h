@@ -1,12 +1,33 @@
 // File FHsort.h
 // Template definitions for vector sorting.  Specifically, include this file
-// to use for any array sort when the class overloads the < operator
+// to use for any array sort when the class overloads the < operator.
+// Every sort also takes an optional comparator (see FHcompare.h)
+// Versions over iterator ranges and raw arrays are in FHsortRange.h
+#ifndef FHSORT_H
+#define FHSORT_H
 
 #include "FHvector.h"
+#include "FHcompare.h"
+#include "FHbinHeap.h"
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+using namespace std;
 
-// version that takes vector
 template <typename Comparable>
-void insertionSort( FHvector<Comparable> & a )
+inline void mySwapFH(Comparable &x, Comparable &y)
+{
+   Comparable tmp = x;
+   x = y;
+   y = tmp;
+}
+
+// version that takes vector
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void insertionSort( FHvector<Comparable> & a, Compare less = Compare() )
 {
     int k, pos, arraySize;
     Comparable tmp;
@@ -15,15 +36,15 @@ void insertionSort( FHvector<Comparable> & a )
     for(pos = 1; pos < arraySize; pos++ )
     {
         tmp = a[pos];
-        for(k = pos; k > 0 && tmp < a[k - 1]; k--)
+        for(k = pos; k > 0 && less(tmp, a[k - 1]); k--)
             a[k] = a[k - 1];
         a[k] = tmp;
     }
 }
 
 // internal ugly version
-template <typename Iterator, typename Comparable>
-void insertionSort(Iterator begin, Iterator end, Comparable x)
+template <typename Iterator, typename Comparable, typename Compare>
+void insertionSort(Iterator begin, Iterator end, Comparable x, Compare less)
 {
    Iterator pos, k;
    Comparable tmp;
@@ -31,13 +52,20 @@ void insertionSort(Iterator begin, Iterator end, Comparable x)
    for(pos = begin; pos != end; pos++ )
    {
       tmp = *pos;
-      for(k = pos; k != begin && tmp < *(k-1); k-- )
+      for(k = pos; k != begin && less(tmp, *(k-1)); k-- )
          *k = *(k-1);
       *k = tmp;
    }
 }
 
-// version that takes two iterators, compatible with STL iterators
+template <typename Iterator, typename Comparable>
+void insertionSort(Iterator begin, Iterator end, Comparable x)
+{
+   insertionSort(begin, end, x, FHless<Comparable>());
+}
+
+// version that takes two iterators, compatible with STL iterators.
+// to pass a comparator, use insertionSort(begin, end, *begin, less)
 template <typename Iterator>
 void insertionSort(Iterator begin, Iterator end)
 {
@@ -46,12 +74,12 @@ void insertionSort(Iterator begin, Iterator end)
 }
 
 // alternative that allows client to pass type, but requires instantiation
-template <class Comparable>
+template <class Comparable, class Compare = FHless<Comparable> >
 class insertionSortOfType
 {
 public:
    template <typename Iterator>
-   insertionSortOfType(Iterator begin, Iterator end)
+   insertionSortOfType(Iterator begin, Iterator end, Compare less = Compare())
    {
       Iterator pos, k;
       Comparable tmp;
@@ -59,7 +87,7 @@ public:
       for(pos = begin; pos != end; pos++ )
       {
          tmp = *pos;
-         for(k = pos; k != begin && tmp < *(k-1); k-- )
+         for(k = pos; k != begin && less(tmp, *(k-1)); k-- )
             *k = *(k-1);
          *k = tmp;
       }
@@ -67,8 +95,9 @@ public:
 };
 
 // version that takes vector and range
-template <typename Comparable>
-void insertionSort(FHvector<Comparable> & a, int left, int right)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void insertionSort(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
 {
     int k, pos;
     Comparable tmp;
@@ -76,15 +105,15 @@ void insertionSort(FHvector<Comparable> & a, int left, int right)
     for(pos = left + 1; pos <= right; pos++ )
     {
         tmp = a[pos];
-        for(k = pos; k > left && tmp < a[k - 1]; k--)
+        for(k = pos; k > left && less(tmp, a[k - 1]); k--)
             a[k] = a[k - 1];
         a[k] = tmp;
     }
 }
 
 // shellSort #1 -- using shell's outer loop
-template <typename Comparable>
-void shellSort1( FHvector<Comparable> & a )
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void shellSort1( FHvector<Comparable> & a, Compare less = Compare() )
 {
    int k, pos, arraySize, gap;
    Comparable tmp;
@@ -94,16 +123,118 @@ void shellSort1( FHvector<Comparable> & a )
       for(pos = gap ; pos < arraySize; pos++ )   // middle loop (outer of "insertion-sort")
       {
          tmp = a[pos];
-         for(k = pos; k >= gap && tmp < a[k - gap]; k -= gap )   // inner loop
+         for(k = pos; k >= gap && less(tmp, a[k - gap]); k -= gap )   // inner loop
             a[k] = a[k - gap];
          a[k] = tmp;
    }
 }
 
+// shellSort with a choice of gap sequence.  all are in place and
+// allocation-free; the gaps are computed as needed.
+//    SHELL_GAPS      n/2, n/4, ..., 1 as in shellSort1 (O(n^2) worst case)
+//    CIURA_GAPS      1, 4, 10, 23, 57, 132, 301, 701, then * 2.25
+//    TOKUDA_GAPS     ceil((9 (9/4)^k - 4) / 5): 1, 4, 9, 20, 46, 103, ...
+//    SEDGEWICK_GAPS  1, 8, 23, 77, 281, ... = 4^k + 3 2^(k-1) + 1
+// DEFAULT_GAPS was chosen with FHsortBenchClient (shellSort* sorts): with
+// fewer, more widely spaced gaps, Sedgewick's makes fewer passes over the
+// array and was fastest for most types and sizes, although Ciura's does
+// about 20% fewer comparisons - better when those are very expensive
+enum FHgapSequence { SHELL_GAPS, CIURA_GAPS, TOKUDA_GAPS, SEDGEWICK_GAPS };
+#define DEFAULT_GAPS SEDGEWICK_GAPS
+
+// the k-th gap (k = 0 gives 1) of an increasing sequence, for arrays of
+// arraySize items; 0 once the gaps reach arraySize
+inline int shellGap(FHgapSequence gaps, int k, int arraySize)
+{
+   static const int ciura[] = { 1, 4, 10, 23, 57, 132, 301, 701 };
+   double gap;
+   int j;
+
+   switch (gaps)
+   {
+   case SHELL_GAPS:
+      // j gaps, arraySize/2 down to 1, halving: k counts from the end
+      for (j = 0; (arraySize >> (j + 1)) > 0; j++)
+         ;
+      gap = k < j ? arraySize >> (j - k) : 0;
+      break;
+   case CIURA_GAPS:
+      if (k < 8)
+         gap = ciura[k];
+      else
+         for (gap = ciura[7], j = 7; j < k; j++)
+            gap = (int)(gap * 2.25);
+      break;
+   case TOKUDA_GAPS:
+      for (gap = 9, j = 0; j < k; j++)
+         gap *= 2.25;
+      gap = ceil((gap - 4) / 5);
+      break;
+   default:   // SEDGEWICK_GAPS
+      gap = k == 0 ? 1 : ldexp(1.0, 2 * k) + 3 * ldexp(1.0, k - 1) + 1;
+      break;
+   }
+   return gap > 0 && gap < arraySize ? (int)gap : 0;
+}
+
+// one pass of shellSort: insertion sorts, gap apart, the chains that
+// start at firstChain .. lastChain - 1.  chains are independent, so
+// different ones can be sorted at the same time.  rows (gap items long)
+// are visited in order, which keeps the memory access sequential
+template <typename Iterator, typename Compare>
+void shellGapPass(Iterator a, int arraySize, int gap, int firstChain,
+   int lastChain, Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int k, pos, row, rowStop;
+   Comparable tmp;
+
+   for (row = gap; row < arraySize; row += gap)
+   {
+      rowStop = row + lastChain < arraySize ? row + lastChain : arraySize;
+      for (pos = row + firstChain; pos < rowStop; pos++)
+      {
+         tmp = std::move(a[pos]);
+         for (k = pos; k >= gap && less(tmp, a[k - gap]); k -= gap)
+            a[k] = std::move(a[k - gap]);
+         a[k] = std::move(tmp);
+      }
+   }
+}
+
+// shellSort internal, over a[0 .. arraySize)
+template <typename Iterator, typename Compare>
+void shellSort(Iterator a, int arraySize, FHgapSequence gaps, Compare less)
+{
+   int k, gap;
+
+   for (k = 0; shellGap(gaps, k, arraySize) > 0; k++)
+      ;
+   while (--k >= 0)
+   {
+      gap = shellGap(gaps, k, arraySize);
+      shellGapPass(a, arraySize, gap, 0, gap, less);
+   }
+}
+
+// shellSort public drivers
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void shellSort(FHvector<Comparable> & a, FHgapSequence gaps,
+   Compare less = Compare())
+{
+   shellSort(a.begin(), a.size(), gaps, less);
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void shellSort(FHvector<Comparable> & a, Compare less = Compare())
+{
+   shellSort(a.begin(), a.size(), DEFAULT_GAPS, less);
+}
+
 // mergesort helper, merge
-template <typename Comparable>
+template <typename Comparable, typename Compare = FHless<Comparable> >
 void merge(FHvector<Comparable> & client, FHvector<Comparable> & working,
-   int leftPos, int rightPos, int rightStop)
+   int leftPos, int rightPos, int rightStop, Compare less = Compare())
 {
    int leftStop, workingPos, arraySize;
 
@@ -111,9 +242,10 @@ void merge(FHvector<Comparable> & client, FHvector<Comparable> & working,
    leftStop = rightPos - 1;
    arraySize = rightStop - leftPos + 1;
 
-   // as soon as we reach the end of either input array, stop
+   // as soon as we reach the end of either input array, stop.
+   // ties go to the left run, which keeps the sort stable
    while(leftPos <= leftStop && rightPos <= rightStop)
-      if(client[leftPos] < client[rightPos])
+      if( !less(client[rightPos], client[leftPos]) )
          working[workingPos++] = client[leftPos++];
       else
          working[workingPos++] = client[rightPos++];
@@ -130,9 +262,9 @@ void merge(FHvector<Comparable> & client, FHvector<Comparable> & working,
 }
 
 // mergesort internal
-template <typename Comparable>
+template <typename Comparable, typename Compare = FHless<Comparable> >
 void mergeSort(FHvector<Comparable> & a, FHvector<Comparable> & working,
-   int start, int stop)
+   int start, int stop, Compare less = Compare())
 {
    int rightStart;
 
@@ -140,215 +272,1905 @@ void mergeSort(FHvector<Comparable> & a, FHvector<Comparable> & working,
       return;
 
    rightStart = (start + stop)/2 + 1;
-   mergeSort(a, working, start, rightStart - 1);
-   mergeSort(a, working, rightStart, stop);
-   merge(a, working, start, rightStart, stop);
+   mergeSort(a, working, start, rightStart - 1, less);
+   mergeSort(a, working, rightStart, stop, less);
+   merge(a, working, start, rightStart, stop, less);
 }
 
 // mergesort public driver 
-template <typename Comparable>
-void mergeSort(FHvector<Comparable> & a)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void mergeSort(FHvector<Comparable> & a, Compare less = Compare())
 {
    if (a.size() < 2)
       return;
 
    FHvector<Comparable> working(a.size());
-   mergeSort(a, working, 0, a.size() - 1);
+   mergeSort(a, working, 0, a.size() - 1, less);
 }
 
-template <typename Comparable>
-void percolateDown(FHvector<Comparable> & inArray, int hole, int arraySize)
-{ 
-   int child;
-   Comparable tmp;
+#define MS_RUN_SIZE 32
 
-   for( tmp = inArray[hole]; 2 * hole + 1 < arraySize; hole = child )
+// bottom-up mergesort helper: merges src[left..mid-1] with src[mid..right]
+// into dst[left..right].  unlike merge() there is no copy back; the caller
+// swaps the roles of the two arrays on the next pass
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void mergeInto(const FHvector<Comparable> & src, FHvector<Comparable> & dst,
+   int left, int mid, int right, Compare less = Compare())
+{
+   int leftPos, rightPos, dstPos;
+
+   // lone tail run, or runs already in order (one comparison): just copy
+   if ( mid > right || !less(src[mid], src[mid - 1]) )
    {
-      child = 2 * hole + 1;
-      // if 2 children, get the GREATER of the two (because MAX heap)
-      if( child < arraySize - 1 && inArray[child] < inArray[child + 1])
-         child++;
-      if( tmp < inArray[child] )   // MAX heap, not min heap
-         inArray[hole] = inArray[child];
-      else
-         break;
+      for ( ; left <= right; left++)
+         dst[left] = src[left];
+      return;
    }
-   inArray[hole] = tmp;
-}
 
-template <typename Comparable>
-inline void mySwapFH(Comparable &x, Comparable &y)
-{
-   Comparable tmp = x;
-   x = y;
-   y = tmp;
+   leftPos = dstPos = left;
+   rightPos = mid;
+   while (leftPos < mid && rightPos <= right)
+      if ( !less(src[rightPos], src[leftPos]) )
+         dst[dstPos++] = src[leftPos++];
+      else
+         dst[dstPos++] = src[rightPos++];
+   while (leftPos < mid)
+      dst[dstPos++] = src[leftPos++];
+   while (rightPos <= right)
+      dst[dstPos++] = src[rightPos++];
 }
 
-template <typename Comparable>
-void heapSort(FHvector<Comparable> & inArray)
+// bottom-up mergesort internal: sorts a[left] ... a[right] using the same
+// index range of working.  runs of MS_RUN_SIZE are insertion sorted, then
+// passes of doubling width merge back and forth between the two arrays, so
+// each item moves once per pass.  stable, like mergeSort
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void mergeSortBottomUp(FHvector<Comparable> & a,
+   FHvector<Comparable> & working, int left, int right,
+   Compare less = Compare())
 {
-   int k, arraySize;
+   int k, width, start, mid, stop;
+   bool inWorking = false;
 
-   // order the array using percolate down
-   arraySize = inArray.size();
-   for(k = arraySize/2; k >= 0; k-- )
-      percolateDown(inArray, k, arraySize);
+   for (start = left; start <= right; start += MS_RUN_SIZE)
+   {
+      stop = start + MS_RUN_SIZE - 1;
+      insertionSort(a, start, stop < right ? stop : right, less);
+   }
 
-   // now remove the max element (root) and place at end of array
-   for(k = arraySize - 1; k > 0; k-- )
+   for (width = MS_RUN_SIZE; width <= right - left; width *= 2)
    {
-      mySwapFH(inArray[0], inArray[k]); // "remove" by placing at end of array
-      percolateDown( inArray, 0, k );  // k represents the shrinking array size
+      FHvector<Comparable> & src = inWorking ? working : a;
+      FHvector<Comparable> & dst = inWorking ? a : working;
+
+      for (start = left; start <= right; start += 2 * width)
+      {
+         mid = start + width;
+         stop = mid + width - 1;
+         mergeInto(src, dst, start, mid, stop < right ? stop : right, less);
+      }
+      inWorking = !inWorking;
    }
+
+   // odd number of passes: the result is in working
+   if (inWorking)
+      for (k = left; k <= right; k++)
+         a[k] = working[k];
 }
 
-// quickSort helper
-// median3 sorts a[left], a[center] and a[right].
-// it leaves the smallest in a[left], the largest in a[right]
-// and median (the pivot) is moved "out-of-the-way" in a[right-1].
-// (a[center] has what used to be in a[right-1])
-template <typename Comparable>
-const Comparable & median3(FHvector<Comparable> & a, int left, int right)
+// bottom-up mergesort public driver
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void mergeSortBottomUp(FHvector<Comparable> & a, Compare less = Compare())
 {
-   int center;
-
-   center = (left + right) / 2;
-   if(a[center] < a[left])
-      mySwapFH(a[left], a[center]);
-   if(a[right] < a[left])
-     mySwapFH( a[left], a[right] );
-   if(a[right] < a[center])
-      mySwapFH(a[center], a[right]);
+   if (a.size() < 2)
+      return;
 
-   mySwapFH(a[center], a[right - 1]);
-   return a[right - 1];
+   FHvector<Comparable> working(a.size());
+   mergeSortBottomUp(a, working, 0, a.size() - 1, less);
 }
 
-#define QS_RECURSION_LIMIT 15
+#define TIM_MIN_MERGE 32   // shorter arrays: one binary insertion sort
+#define TIM_MIN_GALLOP 7   // wins in a row before a merge starts galloping
 
-// quickSort internal
-template <typename Comparable>
-void quickSort(FHvector<Comparable> & a, int left, int right)
+// FHtimSort - adaptive, stable natural merge sort (Tim Peters' listsort).
+// the array is cut into natural runs (descending runs are reversed), short
+// runs are extended to minRun by binary insertion, and runs are merged as
+// they pile up on a stack whose lengths shrink at least like Fibonacci
+// numbers, so merges stay balanced.  when one run keeps winning, the merge
+// switches to galloping (exponential then binary search) and copies whole
+// stretches at once.  sorted or nearly sorted input costs about O(n).
+// use it through timSort()
+template <typename Comparable, typename Compare>
+class FHtimSort
 {
-   Comparable pivot;
-   int i, j;
+private:
+   FHvector<Comparable> & a;
+   Compare less;
+   FHvector<Comparable> tmp;     // merge buffer, up to n/2 items
+   FHvector<int> runBase, runLen;
+   int minGallop;
 
-   if( left + QS_RECURSION_LIMIT <= right )
+public:
+   FHtimSort(FHvector<Comparable> & array, Compare lessArg)
+      : a(array), less(lessArg), minGallop(TIM_MIN_GALLOP) { }
+   void sort(int lo, int hi);
+
+private:
+   static int minRunLength(int n);
+   int countRunAndMakeAscending(int lo, int hi);
+   void binaryInsertionSort(int lo, int hi, int start);
+   void mergeCollapse();
+   void mergeForceCollapse();
+   void mergeAt(int i);
+   int gallopLeft(const Comparable & key, const FHvector<Comparable> & arr,
+      int base, int len, int hint);
+   int gallopRight(const Comparable & key, const FHvector<Comparable> & arr,
+      int base, int len, int hint);
+   void mergeLo(int base1, int len1, int base2, int len2);
+   void mergeLoRuns(int & cursor1, int & cursor2, int & dest,
+      int & len1, int & len2);
+   void mergeHi(int base1, int len1, int base2, int len2);
+   void mergeHiRuns(int & cursor1, int & cursor2, int & dest,
+      int & len1, int & len2);
+   void ensureTmp(int size) { if (tmp.size() < size) tmp.resize(size); }
+};
+
+// FHtimSort method definitions -------------------
+// sorts a[lo] ... a[hi - 1]
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::sort(int lo, int hi)
+{
+   int remaining = hi - lo, minRun, runLength, force;
+
+   if (remaining < 2)
+      return;
+
+   if (remaining < TIM_MIN_MERGE)
+   {
+      binaryInsertionSort(lo, hi, lo + countRunAndMakeAscending(lo, hi));
+      return;
+   }
+
+   minRun = minRunLength(remaining);
+   do
    {
-      pivot = median3(a, left, right);
-      for(i = left, j = right - 1; ; )
+      runLength = countRunAndMakeAscending(lo, hi);
+      if (runLength < minRun)
       {
-         while( a[++i] < pivot )
-            ;
-         while( pivot < a[--j])
-            ;
-         if(i < j)
-            mySwapFH(a[i], a[j]);
-         else
-            break;
+         force = remaining < minRun ? remaining : minRun;
+         binaryInsertionSort(lo, lo + force, lo + runLength);
+         runLength = force;
       }
 
-      mySwapFH(a[i], a[right - 1]);  // restore pivot
+      runBase.push_back(lo);
+      runLen.push_back(runLength);
+      mergeCollapse();
 
-      // recursive calls on smaller sub-groups
-      quickSort(a, left, i - 1);     
-      quickSort(a, i + 1, right);    
-   }
-   else
-      // non-recursive escape valve - insertionSort
-      insertionSort(a, left, right);
+      lo += runLength;
+      remaining -= runLength;
+   } while (remaining != 0);
+
+   mergeForceCollapse();
 }
 
-// quickSort public driver
-template <typename Comparable>
-void quickSort( FHvector<Comparable> & a )
+// minRun in [TIM_MIN_MERGE/2, TIM_MIN_MERGE] such that n / minRun is
+// a power of 2 or a little less, so the final merges are balanced
+template <typename Comparable, typename Compare>
+int FHtimSort<Comparable, Compare>::minRunLength(int n)
 {
-    quickSort(a, 0, a.size() - 1);
+   int r = 0;
+
+   while (n >= TIM_MIN_MERGE)
+   {
+      r |= n & 1;
+      n >>= 1;
+   }
+   return n + r;
 }
 
-// smart pointer for indirect sort
-template <typename Comparable>
-class SmartPointer
+// length of the run starting at lo.  a strictly descending run is
+// reversed; equal items never start or extend one, which keeps stability
+template <typename Comparable, typename Compare>
+int FHtimSort<Comparable, Compare>::countRunAndMakeAscending(int lo, int hi)
 {
-private:
-   Comparable *pointee;
+   int runHi = lo + 1, left, right;
 
-public:
-   Comparable * operator=(Comparable *rhs);
-   SmartPointer<Comparable> & operator=(const SmartPointer<Comparable>  &rhs);
-   bool operator<( const SmartPointer<Comparable> & rhs ) const;
-   bool operator!=(const SmartPointer<Comparable> & rhs) const;
-   bool operator!=(const Comparable *rhs) const;
-   int operator-(const Comparable *rhs) const;
-   Comparable operator*() const  { return *pointee; }
-};
+   if (runHi == hi)
+      return 1;
 
-// SmartPointer method definitions ----------------
-template <typename Comparable>
-Comparable * SmartPointer<Comparable>::operator=(Comparable *rhs)
+   if (less(a[runHi++], a[lo]))
+   {
+      while (runHi < hi && less(a[runHi], a[runHi - 1]))
+         runHi++;
+      for (left = lo, right = runHi - 1; left < right; left++, right--)
+         mySwapFH(a[left], a[right]);
+   }
+   else
+      while (runHi < hi && !less(a[runHi], a[runHi - 1]))
+         runHi++;
+
+   return runHi - lo;
+}
+
+// a[lo..start-1] is sorted; inserts a[start..hi-1] into it, finding each
+// spot by binary search (after the last equal item, for stability)
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::binaryInsertionSort(int lo, int hi,
+   int start)
 {
-   return (pointee = rhs);
+   int left, right, mid, k;
+   Comparable pivot;
+
+   for ( ; start < hi; start++)
+   {
+      pivot = std::move(a[start]);
+      for (left = lo, right = start; left < right; )
+      {
+         mid = (left + right) / 2;
+         if (less(pivot, a[mid]))
+            right = mid;
+         else
+            left = mid + 1;
+      }
+      for (k = start; k > left; k--)
+         a[k] = std::move(a[k - 1]);
+      a[left] = std::move(pivot);
+   }
 }
 
-template <typename Comparable>
-SmartPointer<Comparable> & SmartPointer<Comparable>::operator=(
-   const SmartPointer<Comparable>  &rhs)
+// merges until, for the top three runs X, Y, Z (Z newest), the lengths
+// satisfy X > Y + Z and Y > Z (checked one run deeper too)
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeCollapse()
 {
-   pointee = rhs.pointee;
-   return *this;
+   int n;
+
+   while (runLen.size() > 1)
+   {
+      n = runLen.size() - 2;
+      if ( (n > 0 && runLen[n - 1] <= runLen[n] + runLen[n + 1])
+         || (n > 1 && runLen[n - 2] <= runLen[n - 1] + runLen[n]) )
+      {
+         if (runLen[n - 1] < runLen[n + 1])
+            n--;
+      }
+      else if (runLen[n] > runLen[n + 1])
+         break;
+      mergeAt(n);
+   }
 }
 
-template <typename Comparable>
-bool SmartPointer<Comparable>::operator<( const SmartPointer<Comparable> & rhs ) const
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeForceCollapse()
 {
-   return *pointee < *rhs.pointee;
+   int n;
+
+   while (runLen.size() > 1)
+   {
+      n = runLen.size() - 2;
+      if (n > 0 && runLen[n - 1] < runLen[n + 1])
+         n--;
+      mergeAt(n);
+   }
 }
 
-template <typename Comparable>
-bool SmartPointer<Comparable>::operator!=(const SmartPointer<Comparable> & rhs) const
+// merges stack runs i and i + 1
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeAt(int i)
 {
-   return pointee != rhs.pointee;
+   int k, base1 = runBase[i], len1 = runLen[i];
+   int base2 = runBase[i + 1], len2 = runLen[i + 1];
+
+   runLen[i] = len1 + len2;
+   for (k = i + 1; k < runLen.size() - 1; k++)
+   {
+      runBase[k] = runBase[k + 1];
+      runLen[k] = runLen[k + 1];
+   }
+   runBase.pop_back();
+   runLen.pop_back();
+
+   // items of run 1 before run 2's first, and of run 2 after run 1's last,
+   // are already in place
+   k = gallopRight(a[base2], a, base1, len1, 0);
+   base1 += k;
+   len1 -= k;
+   if (len1 == 0)
+      return;
+   len2 = gallopLeft(a[base1 + len1 - 1], a, base2, len2, len2 - 1);
+   if (len2 == 0)
+      return;
+
+   // buffer the shorter run
+   if (len1 <= len2)
+      mergeLo(base1, len1, base2, len2);
+   else
+      mergeHi(base1, len1, base2, len2);
 }
 
-template <typename Comparable>
-bool SmartPointer<Comparable>::operator!=(const Comparable *rhs) const
+// position in arr[base..base+len-1] (sorted) to insert key before any
+// equal items.  searches outward from hint in steps 1, 3, 7, 15, ...
+// and then binary searches the last step
+template <typename Comparable, typename Compare>
+int FHtimSort<Comparable, Compare>::gallopLeft(const Comparable & key,
+   const FHvector<Comparable> & arr, int base, int len, int hint)
 {
-   return pointee != rhs;
+   int lastOfs = 0, ofs = 1, maxOfs, m, k;
+
+   if (less(arr[base + hint], key))
+   {
+      // arr[base+hint] < key: gallop right
+      maxOfs = len - hint;
+      while (ofs < maxOfs && less(arr[base + hint + ofs], key))
+      {
+         lastOfs = ofs;
+         ofs = 2 * ofs + 1;
+         if (ofs <= 0)     // overflow
+            ofs = maxOfs;
+      }
+      if (ofs > maxOfs)
+         ofs = maxOfs;
+      lastOfs += hint;
+      ofs += hint;
+   }
+   else
+   {
+      // key <= arr[base+hint]: gallop left
+      maxOfs = hint + 1;
+      while (ofs < maxOfs && !less(arr[base + hint - ofs], key))
+      {
+         lastOfs = ofs;
+         ofs = 2 * ofs + 1;
+         if (ofs <= 0)
+            ofs = maxOfs;
+      }
+      if (ofs > maxOfs)
+         ofs = maxOfs;
+      k = lastOfs;
+      lastOfs = hint - ofs;
+      ofs = hint - k;
+   }
+
+   // now arr[base+lastOfs] < key <= arr[base+ofs]
+   for (lastOfs++; lastOfs < ofs; )
+   {
+      m = lastOfs + (ofs - lastOfs) / 2;
+      if (less(arr[base + m], key))
+         lastOfs = m + 1;
+      else
+         ofs = m;
+   }
+   return ofs;
 }
 
-template <typename Comparable>
-int SmartPointer<Comparable>::operator-(const Comparable *rhs) const
+// like gallopLeft, but inserts key after any equal items
+template <typename Comparable, typename Compare>
+int FHtimSort<Comparable, Compare>::gallopRight(const Comparable & key,
+   const FHvector<Comparable> & arr, int base, int len, int hint)
 {
-   return pointee - rhs;
+   int lastOfs = 0, ofs = 1, maxOfs, m, k;
+
+   if (less(key, arr[base + hint]))
+   {
+      // key < arr[base+hint]: gallop left
+      maxOfs = hint + 1;
+      while (ofs < maxOfs && less(key, arr[base + hint - ofs]))
+      {
+         lastOfs = ofs;
+         ofs = 2 * ofs + 1;
+         if (ofs <= 0)
+            ofs = maxOfs;
+      }
+      if (ofs > maxOfs)
+         ofs = maxOfs;
+      k = lastOfs;
+      lastOfs = hint - ofs;
+      ofs = hint - k;
+   }
+   else
+   {
+      // arr[base+hint] <= key: gallop right
+      maxOfs = len - hint;
+      while (ofs < maxOfs && !less(key, arr[base + hint + ofs]))
+      {
+         lastOfs = ofs;
+         ofs = 2 * ofs + 1;
+         if (ofs <= 0)
+            ofs = maxOfs;
+      }
+      if (ofs > maxOfs)
+         ofs = maxOfs;
+      lastOfs += hint;
+      ofs += hint;
+   }
+
+   // now arr[base+lastOfs] <= key < arr[base+ofs]
+   for (lastOfs++; lastOfs < ofs; )
+   {
+      m = lastOfs + (ofs - lastOfs) / 2;
+      if (less(key, arr[base + m]))
+         ofs = m;
+      else
+         lastOfs = m + 1;
+   }
+   return ofs;
 }
 
-// indirect sort - uses SmartPointer as intermediate type
-template <typename Comparable>
-void indirectSort( FHvector<Comparable> & a )
+// merges adjacent runs with run 1 (the shorter) copied to tmp, filling a
+// from the left.  run 2's first item goes first and run 1's last goes last
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeLo(int base1, int len1,
+   int base2, int len2)
 {
-   int k, j, nextJ, arraySize = a.size();
-   Comparable tmp;
-   FHvector< SmartPointer<Comparable> > p(arraySize);
+   int k, cursor1 = 0, cursor2 = base2, dest = base1;
 
-   // copy smart pointer to the client array
-   for( k = 0; k < arraySize; k++ )
-      p[k] = &a[k];
+   ensureTmp(len1);
+   for (k = 0; k < len1; k++)
+      tmp[k] = std::move(a[base1 + k]);
 
-   // do the sort - it only changes the smart pointer order
-   quickSort(p);
+   a[dest++] = std::move(a[cursor2++]);
+   if (--len2 > 0 && len1 > 1)
+      mergeLoRuns(cursor1, cursor2, dest, len1, len2);
 
-   // untangle the client elements so they match the pointer order
-   for(k = 0; k < a.size( ); k++ )
-      if( p[k] != &a[k] )
+   // what's left: run 2's tail is already in place after run 1's
+   for (k = 0; k < len2; k++)
+      a[dest + k] = std::move(a[cursor2 + k]);
+   for (k = 0; k < len1; k++)
+      a[dest + len2 + k] = std::move(tmp[cursor1 + k]);
+}
+
+// mergeLo's main loop; returns with len2 == 0 or len1 <= 1
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeLoRuns(int & cursor1,
+   int & cursor2, int & dest, int & len1, int & len2)
+{
+   int k, count1, count2;
+
+   for ( ; ; )
+   {
+      // one at a time, until one run wins minGallop times in a row
+      count1 = count2 = 0;
+      do
       {
-         tmp = a[k];
-         for(j = k; p[j] != &a[k]; j = nextJ)
+         if (less(a[cursor2], tmp[cursor1]))
          {
-            nextJ = p[j] - &a[0];
-            a[j] = *p[j];
-            p[j] = &a[j];
+            a[dest++] = std::move(a[cursor2++]);
+            count2++;
+            count1 = 0;
+            if (--len2 == 0)
+               return;
          }
-         a[j] = tmp;
-         p[j] = &a[j];
-      }
+         else
+         {
+            a[dest++] = std::move(tmp[cursor1++]);
+            count1++;
+            count2 = 0;
+            if (--len1 == 1)
+               return;
+         }
+      } while ( (count1 | count2) < minGallop );
+
+      // galloping: find and copy whole stretches, while that pays
+      do
+      {
+         count1 = gallopRight(a[cursor2], tmp, cursor1, len1, 0);
+         for (k = 0; k < count1; k++)
+            a[dest++] = std::move(tmp[cursor1++]);
+         len1 -= count1;
+         if (len1 <= 1)
+            return;
+         a[dest++] = std::move(a[cursor2++]);
+         if (--len2 == 0)
+            return;
+
+         count2 = gallopLeft(tmp[cursor1], a, cursor2, len2, 0);
+         for (k = 0; k < count2; k++)
+            a[dest++] = std::move(a[cursor2++]);
+         len2 -= count2;
+         if (len2 == 0)
+            return;
+         a[dest++] = std::move(tmp[cursor1++]);
+         if (--len1 == 1)
+            return;
+
+         minGallop--;
+      } while (count1 >= TIM_MIN_GALLOP || count2 >= TIM_MIN_GALLOP);
+
+      // galloping stopped paying: make it harder to start again
+      if (minGallop < 0)
+         minGallop = 0;
+      minGallop += 2;
+   }
 }
+
+// mirror image of mergeLo: run 2 (the shorter) goes to tmp and a is
+// filled from the right
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeHi(int base1, int len1,
+   int base2, int len2)
+{
+   int k, cursor1 = base1 + len1 - 1, cursor2 = len2 - 1;
+   int dest = base2 + len2 - 1;
+
+   ensureTmp(len2);
+   for (k = 0; k < len2; k++)
+      tmp[k] = std::move(a[base2 + k]);
+
+   a[dest--] = std::move(a[cursor1--]);
+   if (--len1 > 0 && len2 > 1)
+      mergeHiRuns(cursor1, cursor2, dest, len1, len2);
+
+   // what's left: run 1's head is already in place before run 2's
+   for (k = 0; k < len1; k++)
+      a[dest - k] = std::move(a[cursor1 - k]);
+   for (k = 0; k < len2; k++)
+      a[dest - len1 - k] = std::move(tmp[cursor2 - k]);
+}
+
+// mergeHi's main loop; returns with len1 == 0 or len2 <= 1
+template <typename Comparable, typename Compare>
+void FHtimSort<Comparable, Compare>::mergeHiRuns(int & cursor1,
+   int & cursor2, int & dest, int & len1, int & len2)
+{
+   int k, count1, count2;
+
+   for ( ; ; )
+   {
+      count1 = count2 = 0;
+      do
+      {
+         if (less(tmp[cursor2], a[cursor1]))
+         {
+            a[dest--] = std::move(a[cursor1--]);
+            count1++;
+            count2 = 0;
+            if (--len1 == 0)
+               return;
+         }
+         else
+         {
+            a[dest--] = std::move(tmp[cursor2--]);
+            count2++;
+            count1 = 0;
+            if (--len2 == 1)
+               return;
+         }
+      } while ( (count1 | count2) < minGallop );
+
+      do
+      {
+         count1 = len1 - gallopRight(tmp[cursor2], a, cursor1 - len1 + 1,
+            len1, len1 - 1);
+         for (k = 0; k < count1; k++)
+            a[dest--] = std::move(a[cursor1--]);
+         len1 -= count1;
+         if (len1 == 0)
+            return;
+         a[dest--] = std::move(tmp[cursor2--]);
+         if (--len2 == 1)
+            return;
+
+         count2 = len2 - gallopLeft(a[cursor1], tmp, 0, len2, len2 - 1);
+         for (k = 0; k < count2; k++)
+            a[dest--] = std::move(tmp[cursor2--]);
+         len2 -= count2;
+         if (len2 <= 1)
+            return;
+         a[dest--] = std::move(a[cursor1--]);
+         if (--len1 == 0)
+            return;
+
+         minGallop--;
+      } while (count1 >= TIM_MIN_GALLOP || count2 >= TIM_MIN_GALLOP);
+
+      if (minGallop < 0)
+         minGallop = 0;
+      minGallop += 2;
+   }
+}
+
+// timSort internal: sorts a[left] ... a[right]
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void timSort(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
+{
+   FHtimSort<Comparable, Compare> sorter(a, less);
+
+   sorter.sort(left, right + 1);
+}
+
+// timSort public driver - stable; close to O(n) on nearly sorted data
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void timSort(FHvector<Comparable> & a, Compare less = Compare())
+{
+   timSort(a, 0, a.size() - 1, less);
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void percolateDown(FHvector<Comparable> & inArray, int hole, int arraySize,
+   Compare less = Compare())
+{ 
+   int child;
+   Comparable tmp;
+
+   for( tmp = inArray[hole]; 2 * hole + 1 < arraySize; hole = child )
+   {
+      child = 2 * hole + 1;
+      // if 2 children, get the GREATER of the two (because MAX heap)
+      if( child < arraySize - 1 && less(inArray[child], inArray[child + 1]))
+         child++;
+      if( less(tmp, inArray[child]) )   // MAX heap, not min heap
+         inArray[hole] = inArray[child];
+      else
+         break;
+   }
+   inArray[hole] = tmp;
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void heapSort(FHvector<Comparable> & inArray, Compare less = Compare())
+{
+   int k, arraySize;
+
+   // order the array using percolate down
+   arraySize = inArray.size();
+   for(k = arraySize/2 - 1; k >= 0; k-- )
+      percolateDown(inArray, k, arraySize, less);
+
+   // now remove the max element (root) and place at end of array
+   for(k = arraySize - 1; k > 0; k-- )
+   {
+      mySwapFH(inArray[0], inArray[k]); // "remove" by placing at end of array
+      percolateDown( inArray, 0, k, less );  // k represents the shrinking array size
+   }
+}
+
+// heapSort on the subrange a[left] ... a[right].
+// this percolateDown needs its comparator, so a call with one extra int
+// can't be mistaken for the version above
+template <typename Comparable, typename Compare>
+void percolateDown(FHvector<Comparable> & inArray, int hole, int arraySize,
+   int left, Compare less)
+{ 
+   int child;
+   Comparable tmp;
+
+   for( tmp = inArray[left + hole]; 2 * hole + 1 < arraySize; hole = child )
+   {
+      child = 2 * hole + 1;
+      // if 2 children, get the GREATER of the two (because MAX heap)
+      if( child < arraySize - 1
+         && less(inArray[left + child], inArray[left + child + 1]))
+         child++;
+      if( less(tmp, inArray[left + child]) )   // MAX heap, not min heap
+         inArray[left + hole] = inArray[left + child];
+      else
+         break;
+   }
+   inArray[left + hole] = tmp;
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void heapSort(FHvector<Comparable> & inArray, int left, int right,
+   Compare less = Compare())
+{
+   int k, arraySize;
+
+   arraySize = right - left + 1;
+   for(k = arraySize/2 - 1; k >= 0; k-- )
+      percolateDown(inArray, k, arraySize, left, less);
+
+   for(k = arraySize - 1; k > 0; k-- )
+   {
+      mySwapFH(inArray[left], inArray[left + k]);
+      percolateDown( inArray, 0, k, left, less );
+   }
+}
+
+// heapSortBottomUp helper (Floyd): sifts a[hole] down the max heap
+// a[0] ... a[arraySize - 1].  instead of testing it against the larger
+// child on every level (two comparisons), the hole goes all the way down
+// to a leaf along the larger children (one comparison), and the item
+// then moves back up from there.  the item placed at a[0] in the sort's
+// second phase came from the bottom of the heap, so it seldom moves up
+// more than a level or two
+template <typename Iterator, typename Compare>
+void percolateDownBottomUp(Iterator a, int hole, int arraySize,
+   Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int child, parent, top = hole;
+   Comparable tmp;
+
+   tmp = std::move(a[hole]);
+   for ( ; (child = 2 * hole + 2) < arraySize; hole = child)
+   {
+      if ( less(a[child], a[child - 1]) )
+         child--;
+      a[hole] = std::move(a[child]);
+   }
+   if (child == arraySize)   // only a left child
+   {
+      a[hole] = std::move(a[child - 1]);
+      hole = child - 1;
+   }
+
+   for ( ; hole > top; hole = parent)
+   {
+      parent = (hole - 1) / 2;
+      if ( !less(a[parent], tmp) )
+         break;
+      a[hole] = std::move(a[parent]);
+   }
+   a[hole] = std::move(tmp);
+}
+
+// heapSortBottomUp internal, over a[0 .. arraySize)
+template <typename Iterator, typename Compare>
+void heapSortBottomUp(Iterator a, int arraySize, Compare less)
+{
+   int k;
+
+   for (k = arraySize/2 - 1; k >= 0; k--)
+      percolateDownBottomUp(a, k, arraySize, less);
+   for (k = arraySize - 1; k > 0; k--)
+   {
+      mySwapFH(a[0], a[k]);
+      percolateDownBottomUp(a, 0, k, less);
+   }
+}
+
+// heapSortBottomUp public drivers - heapSort with about half the
+// comparisons; in place, no allocation, O(n log n) worst case.
+// introSort and blockQuickSort fall back on it
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void heapSortBottomUp(FHvector<Comparable> & a, Compare less = Compare())
+{
+   heapSortBottomUp(a.begin(), a.size(), less);
+}
+
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void heapSortBottomUp(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
+{
+   heapSortBottomUp(a.begin() + left, right - left + 1, less);
+}
+
+// quickSort helper
+// median3 sorts a[left], a[center] and a[right].
+// it leaves the smallest in a[left], the largest in a[right]
+// and median (the pivot) is moved "out-of-the-way" in a[right-1].
+// (a[center] has what used to be in a[right-1])
+template <typename Comparable, typename Compare = FHless<Comparable> >
+const Comparable & median3(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
+{
+   int center;
+
+   center = (left + right) / 2;
+   if(less(a[center], a[left]))
+      mySwapFH(a[left], a[center]);
+   if(less(a[right], a[left]))
+     mySwapFH( a[left], a[right] );
+   if(less(a[right], a[center]))
+      mySwapFH(a[center], a[right]);
+
+   mySwapFH(a[center], a[right - 1]);
+   return a[right - 1];
+}
+
+#define QS_RECURSION_LIMIT 15
+
+// quickSort helper
+// partitions a[left] ... a[right] around the median3 pivot and returns
+// the pivot's final position i: a[left..i-1] <= a[i] <= a[i+1..right]
+template <typename Comparable, typename Compare = FHless<Comparable> >
+int quickSortPartition(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
+{
+   Comparable pivot;
+   int i, j;
+
+   pivot = median3(a, left, right, less);
+   for(i = left, j = right - 1; ; )
+   {
+      while( less(a[++i], pivot) )
+         ;
+      while( less(pivot, a[--j]) )
+         ;
+      if(i < j)
+         mySwapFH(a[i], a[j]);
+      else
+         break;
+   }
+
+   mySwapFH(a[i], a[right - 1]);  // restore pivot
+   return i;
+}
+
+// quickSort internal
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void quickSort(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
+{
+   int i;
+
+   if( left + QS_RECURSION_LIMIT <= right )
+   {
+      i = quickSortPartition(a, left, right, less);
+
+      // recursive calls on smaller sub-groups
+      quickSort(a, left, i - 1, less);
+      quickSort(a, i + 1, right, less);
+   }
+   else
+      // non-recursive escape valve - insertionSort
+      insertionSort(a, left, right, less);
+}
+
+// quickSort public driver
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void quickSort( FHvector<Comparable> & a, Compare less = Compare() )
+{
+    quickSort(a, 0, a.size() - 1, less);
+}
+
+// introSort internal: quickSort partitioning, but once depthLimit levels
+// have been used up the range is finished by heapSortBottomUp.  recurses
+// only on the smaller side and loops on the larger, so stack depth is
+// O(log n)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void introSort(FHvector<Comparable> & a, int left, int right, int depthLimit,
+   Compare less = Compare())
+{
+   int i;
+
+   while( left + QS_RECURSION_LIMIT <= right )
+   {
+      if (depthLimit-- == 0)
+      {
+         heapSortBottomUp(a, left, right, less);
+         return;
+      }
+
+      i = quickSortPartition(a, left, right, less);
+
+      // recurse on the smaller sub-group, loop on the larger
+      if (i - left < right - i)
+      {
+         introSort(a, left, i - 1, depthLimit, less);
+         left = i + 1;
+      }
+      else
+      {
+         introSort(a, i + 1, right, depthLimit, less);
+         right = i - 1;
+      }
+   }
+
+   // non-recursive escape valve - insertionSort
+   insertionSort(a, left, right, less);
+}
+
+// introSort public driver - quickSort speed, O(n log n) guaranteed
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void introSort( FHvector<Comparable> & a, Compare less = Compare() )
+{
+   int depthLimit, n;
+
+   for (depthLimit = 0, n = a.size(); n > 1; n /= 2)
+      depthLimit += 2;        // 2 * floor(log2(n))
+   introSort(a, 0, a.size() - 1, depthLimit, less);
+}
+
+#define NETWORK_SORT_MAX 16      // largest range sorted by a network
+#define BLOCK_PARTITION_SIZE 64  // items scanned per block in blockPartition
+
+// sorting network tables: Batcher's odd-even merge sort for 16 items.
+// the table for m items drops every comparator that touches an item past
+// m - as if those items were +infinity, which no comparator would move -
+// so it sorts any m <= 16.  built once, on first use
+class FHsortNetwork
+{
+public:
+   int numPairs[NETWORK_SORT_MAX + 1];
+   unsigned char first[NETWORK_SORT_MAX + 1][64];
+   unsigned char second[NETWORK_SORT_MAX + 1][64];
+
+   FHsortNetwork()
+   {
+      int m, p, k, j, i;
+
+      for (m = 0; m <= NETWORK_SORT_MAX; m++)
+      {
+         numPairs[m] = 0;
+         for (p = 1; p < NETWORK_SORT_MAX; p *= 2)
+            for (k = p; k >= 1; k /= 2)
+               for (j = k % p; j + k < NETWORK_SORT_MAX; j += 2 * k)
+                  for (i = 0; i < k && i + j + k < m; i++)
+                     if ( (i + j) / (2 * p) == (i + j + k) / (2 * p) )
+                     {
+                        first[m][numPairs[m]] = i + j;
+                        second[m][numPairs[m]++] = i + j + k;
+                     }
+      }
+   }
+
+   static const FHsortNetwork & tables()
+   {
+      static const FHsortNetwork network;
+      return network;
+   }
+};
+
+// sorting network helper: leaves the lesser of x, y in x.  written with
+// selects instead of an if, so for numbers it compiles to conditional
+// moves (or min/max instructions) with no branch to mispredict
+template <typename Comparable, typename Compare>
+inline void compareExchange(Comparable & x, Comparable & y, Compare less)
+{
+   bool swap = less(y, x);
+   Comparable lesser = swap ? y : x;
+
+   y = swap ? x : y;
+   x = lesser;
+}
+
+// sorts a[0] ... a[size - 1], size <= NETWORK_SORT_MAX.  the sequence of
+// comparisons is fixed, so none of the branches depend on the data
+template <typename Iterator, typename Compare>
+void networkSort(Iterator a, int size, Compare less)
+{
+   const FHsortNetwork & network = FHsortNetwork::tables();
+   int k;
+
+   for (k = 0; k < network.numPairs[size]; k++)
+      compareExchange(a[network.first[size][k]],
+         a[network.second[size][k]], less);
+}
+
+// blockQuickSort helper: BlockQuicksort partition (Edelkamp and Weiss, as
+// tuned in pdqsort).  the pivot is at begin[0], and some item at or before
+// end[-1] is not less than it.  instead of swapping as soon as a misplaced
+// item is found, each side scans a block and records the offsets of its
+// misplaced items, with the comparison result added to a count rather
+// than branched on; then the recorded items are swapped in bulk.  returns
+// the pivot's final position: items before it are less than the pivot,
+// items after it are not
+template <typename Iterator, typename Compare>
+Iterator blockPartition(Iterator begin, Iterator end, Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   unsigned char offsetsL[BLOCK_PARTITION_SIZE];
+   unsigned char offsetsR[BLOCK_PARTITION_SIZE];
+   Iterator first = begin, last = end, baseL, baseR, l, r;
+   Comparable pivot = std::move(*begin), tmp;
+   int i, num, numL, numR, startL, startR, unknown, splitL, splitR;
+
+   // skip the items already on the correct side
+   while (less(*++first, pivot))
+      ;
+   if (first - 1 == begin)
+      while (first < last && !less(*--last, pivot))
+         ;
+   else
+      while (!less(*--last, pivot))
+         ;
+
+   if (first < last)
+   {
+      mySwapFH(*first, *last);
+      ++first;
+
+      baseL = first;
+      baseR = last;
+      numL = numR = startL = startR = 0;
+      while (first < last)
+      {
+         // refill whichever offset block is empty (splitting what's left
+         // if both are, so the last blocks can be partial)
+         unknown = last - first;
+         splitL = numL == 0 ? (numR == 0 ? unknown / 2 : unknown) : 0;
+         splitR = numR == 0 ? unknown - splitL : 0;
+         if (splitL > BLOCK_PARTITION_SIZE)
+            splitL = BLOCK_PARTITION_SIZE;
+         if (splitR > BLOCK_PARTITION_SIZE)
+            splitR = BLOCK_PARTITION_SIZE;
+
+         for (i = 0; i < splitL; i++)
+         {
+            offsetsL[numL] = i;
+            numL += !less(*first++, pivot);
+         }
+         for (i = 0; i < splitR; )
+         {
+            offsetsR[numR] = ++i;
+            numR += less(*--last, pivot);
+         }
+
+         // swap the misplaced pairs.  as a cycle, one move per item, when
+         // the counts differ; plain swaps when equal (no leftover)
+         num = numL < numR ? numL : numR;
+         if (num > 0 && numL == numR)
+            for (i = 0; i < num; i++)
+               mySwapFH(baseL[offsetsL[startL + i]],
+                  *(baseR - offsetsR[startR + i]));
+         else if (num > 0)
+         {
+            l = baseL + offsetsL[startL];
+            r = baseR - offsetsR[startR];
+            tmp = std::move(*l);
+            *l = std::move(*r);
+            for (i = 1; i < num; i++)
+            {
+               l = baseL + offsetsL[startL + i];
+               *r = std::move(*l);
+               r = baseR - offsetsR[startR + i];
+               *l = std::move(*r);
+            }
+            *r = std::move(tmp);
+         }
+         numL -= num;
+         numR -= num;
+         startL += num;
+         startR += num;
+
+         if (numL == 0)
+         {
+            startL = 0;
+            baseL = first;
+         }
+         if (numR == 0)
+         {
+            startR = 0;
+            baseR = last;
+         }
+      }
+
+      // one side may still have misplaced items: move them to the middle
+      if (numL > 0)
+      {
+         while (numL--)
+            mySwapFH(baseL[offsetsL[startL + numL]], *--last);
+         first = last;
+      }
+      if (numR > 0)
+      {
+         while (numR--)
+            mySwapFH(*(baseR - offsetsR[startR + numR]), *first++);
+         last = first;
+      }
+   }
+
+   // put the pivot between the two sides
+   *begin = std::move(*(first - 1));
+   *(first - 1) = std::move(pivot);
+   return first - 1;
+}
+
+// blockQuickSort helper: for a pivot equal to the item just before begin
+// (the previous pivot, which nothing here is less than).  puts the items
+// equal to it on the left and returns the pivot's position; they are done
+template <typename Iterator, typename Compare>
+Iterator partitionEqualLeft(Iterator begin, Iterator end, Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   Iterator first = begin, last = end;
+   Comparable pivot = std::move(*begin);
+
+   while (less(pivot, *--last))
+      ;
+   if (last + 1 == end)
+      while (first < last && !less(pivot, *++first))
+         ;
+   else
+      while (!less(pivot, *++first))
+         ;
+
+   while (first < last)
+   {
+      mySwapFH(*first, *last);
+      while (less(pivot, *--last))
+         ;
+      while (!less(pivot, *++first))
+         ;
+   }
+
+   *begin = std::move(*last);
+   *last = std::move(pivot);
+   return last;
+}
+
+// blockQuickSort internal: introSort's shape (median of three, smaller
+// side recursed, heapSortBottomUp after depthLimit levels) around
+// blockPartition, with sorting networks for numeric ranges of
+// NETWORK_SORT_MAX or fewer.
+// runs of an item equal to the previous pivot are split off in one pass,
+// so many duplicates don't make it quadratic.  sorts a[left] ... a[right].
+// leftmost is false only when a[left - 1] is an earlier pivot, which
+// nothing in the range is less than; leave it true for any other call
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void blockQuickSort(FHvector<Comparable> & a, int left, int right,
+   int depthLimit, Compare less = Compare(), bool leftmost = true)
+{
+   Comparable *base, *pivotPos;
+   int mid, i;
+
+   if (right - left < 1)
+      return;
+   base = &a[0];
+
+   while (right - left >= NETWORK_SORT_MAX)
+   {
+      if (depthLimit-- == 0)
+      {
+         heapSortBottomUp(a, left, right, less);
+         return;
+      }
+
+      // median of three to base[left]; the max, at base[right], stops the
+      // first scan in blockPartition
+      mid = left + (right - left) / 2;
+      compareExchange(base[mid], base[left], less);
+      compareExchange(base[left], base[right], less);
+      compareExchange(base[mid], base[left], less);
+
+      // equal to the previous pivot (the item before this range):
+      // everything equal to it is already in its final place
+      if (!leftmost && !less(base[left - 1], base[left]))
+      {
+         left = partitionEqualLeft(base + left, base + right + 1, less)
+            - base + 1;
+         continue;
+      }
+
+      pivotPos = blockPartition(base + left, base + right + 1, less);
+      i = pivotPos - base;
+      if (i - left < right - i)
+      {
+         blockQuickSort(a, left, i - 1, depthLimit, less, leftmost);
+         left = i + 1;
+         leftmost = false;
+      }
+      else
+      {
+         blockQuickSort(a, i + 1, right, depthLimit, less, false);
+         right = i - 1;
+      }
+   }
+
+   if (right - left < 1)
+      return;
+   if (is_arithmetic<Comparable>::value)
+      networkSort(base + left, right - left + 1, less);
+   else
+      insertionSort(a, left, right, less);
+}
+
+// blockQuickSort public driver - for int, float, double (and other cheap
+// to compare) keys.  not stable
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void blockQuickSort(FHvector<Comparable> & a, Compare less = Compare())
+{
+   int depthLimit, n;
+
+   for (depthLimit = 0, n = a.size(); n > 1; n /= 2)
+      depthLimit += 2;        // 2 * floor(log2(n))
+   blockQuickSort(a, 0, a.size() - 1, depthLimit, less, true);
+}
+
+// quickSort3Way internal: Bentley-McIlroy three-way partitioning.  keys
+// equal to the pivot are parked at both ends during the scan, then swapped
+// into the middle, and neither recursion sees them again.  sorts with few
+// distinct keys run in near-linear time
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void quickSort3Way(FHvector<Comparable> & a, int left, int right,
+   Compare less = Compare())
+{
+   Comparable pivot;
+   int i, j, p, q, k;
+
+   while( left + QS_RECURSION_LIMIT <= right )
+   {
+      // median of three, moved to a[left]
+      median3(a, left, right, less);
+      mySwapFH(a[left], a[right - 1]);
+      pivot = a[left];
+
+      // a[left..p] and a[q..right] hold keys equal to the pivot
+      i = p = left;
+      j = q = right + 1;
+      for ( ; ; )
+      {
+         while( less(a[++i], pivot) )
+            if (i == right)
+               break;
+         while( less(pivot, a[--j]) )
+            if (j == left)
+               break;
+         if (i == j && !less(pivot, a[i]))
+            mySwapFH(a[++p], a[i]);
+         if (i >= j)
+            break;
+
+         mySwapFH(a[i], a[j]);
+         if ( !less(a[i], pivot) && !less(pivot, a[i]) )
+            mySwapFH(a[++p], a[i]);
+         if ( !less(a[j], pivot) && !less(pivot, a[j]) )
+            mySwapFH(a[--q], a[j]);
+      }
+
+      // swap the equal keys from both ends into the middle
+      i = j + 1;
+      for (k = left; k <= p; k++)
+         mySwapFH(a[k], a[j--]);
+      for (k = right; k >= q; k--)
+         mySwapFH(a[k], a[i++]);
+
+      // now a[left..j] < pivot, a[i..right] > pivot.  recurse on the
+      // smaller side, loop on the larger
+      if (j - left < right - i)
+      {
+         quickSort3Way(a, left, j, less);
+         left = i;
+      }
+      else
+      {
+         quickSort3Way(a, i, right, less);
+         right = j;
+      }
+   }
+
+   // non-recursive escape valve - insertionSort
+   if (left < right)
+      insertionSort(a, left, right, less);
+}
+
+// quickSort3Way public driver - for keys with many duplicates
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void quickSort3Way( FHvector<Comparable> & a, Compare less = Compare() )
+{
+   quickSort3Way(a, 0, a.size() - 1, less);
+}
+
+// selection helper: partitions a[left] ... a[right] around the item now at
+// pivotPos and returns its final position i: a[left..i-1] <= a[i] <=
+// a[i+1..right]
+template <typename Comparable, typename Compare = FHless<Comparable> >
+int partitionAround(FHvector<Comparable> & a, int left, int right,
+   int pivotPos, Compare less = Compare())
+{
+   int i, j;
+
+   mySwapFH(a[pivotPos], a[right]);
+   const Comparable & pivot = a[right];
+   for (i = left - 1, j = right; ; )
+   {
+      while( less(a[++i], pivot) )
+         ;
+      while( less(pivot, a[--j]) )
+         if (j == left)
+            break;
+      if (i < j)
+         mySwapFH(a[i], a[j]);
+      else
+         break;
+   }
+   mySwapFH(a[i], a[right]);
+   return i;
+}
+
+template <typename Comparable, typename Compare>
+void medianOfMediansSelect(FHvector<Comparable> & a, int left, int right,
+   int n, Compare less);
+
+// selection helper: median of the medians of groups of 5.  at least 3/10
+// of a[left..right] is on each side of it, which makes
+// medianOfMediansSelect linear in the worst case.  returns its position
+template <typename Comparable, typename Compare>
+int medianOfMediansPivot(FHvector<Comparable> & a, int left, int right,
+   Compare less)
+{
+   int k, groupEnd, numMedians = 0;
+
+   // sort each group and move its median to the front
+   for (k = left; k <= right; k += 5)
+   {
+      groupEnd = k + 4 < right ? k + 4 : right;
+      insertionSort(a, k, groupEnd, less);
+      mySwapFH(a[left + numMedians++], a[(k + groupEnd) / 2]);
+   }
+
+   medianOfMediansSelect(a, left, left + numMedians - 1,
+      left + (numMedians - 1) / 2, less);
+   return left + (numMedians - 1) / 2;
+}
+
+// selection helper: worst case O(n) select (Blum, Floyd, Pratt, Rivest,
+// Tarjan).  slower on average than quickSortPartition's median3 pivots, so
+// nthElement only falls back on it
+template <typename Comparable, typename Compare>
+void medianOfMediansSelect(FHvector<Comparable> & a, int left, int right,
+   int n, Compare less)
+{
+   int i;
+
+   while( left + QS_RECURSION_LIMIT <= right )
+   {
+      i = partitionAround(a, left, right,
+         medianOfMediansPivot(a, left, right, less), less);
+      if (n == i)
+         return;
+      if (n < i)
+         right = i - 1;
+      else
+         left = i + 1;
+   }
+   insertionSort(a, left, right, less);
+}
+
+// nthElement internal: introselect.  quickSort's median3 partitions, but
+// only the side holding position n is kept.  if three partitions in a row
+// fail to halve the range, the rest is done by medianOfMediansSelect, so
+// the worst case stays O(n)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void nthElement(FHvector<Comparable> & a, int left, int right, int n,
+   Compare less = Compare())
+{
+   int i, steps, checkSize;
+
+   for (steps = 0, checkSize = right - left + 1;
+      left + QS_RECURSION_LIMIT <= right; )
+   {
+      if (++steps == 3)
+      {
+         if (2 * (right - left + 1) > checkSize)
+         {
+            medianOfMediansSelect(a, left, right, n, less);
+            return;
+         }
+         steps = 0;
+         checkSize = right - left + 1;
+      }
+
+      i = quickSortPartition(a, left, right, less);
+      if (n == i)
+         return;
+      if (n < i)
+         right = i - 1;
+      else
+         left = i + 1;
+   }
+   insertionSort(a, left, right, less);
+}
+
+// nthElement public driver - puts in a[n] the item that would be there if
+// a were sorted, with nothing greater before it and nothing less after it
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void nthElement(FHvector<Comparable> & a, int n, Compare less = Compare())
+{
+   if (n < 0 || n >= a.size())
+      return;
+   nthElement(a, 0, a.size() - 1, n, less);
+}
+
+// partialSort - sorts the k least items into a[0] ... a[k-1]; the order of
+// the rest is unspecified.  O(n + k log k)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void partialSort(FHvector<Comparable> & a, int k, Compare less = Compare())
+{
+   int depthLimit, n;
+
+   if (k <= 0)
+      return;
+   if (k >= a.size())
+   {
+      introSort(a, less);
+      return;
+   }
+
+   nthElement(a, 0, a.size() - 1, k - 1, less);
+   for (depthLimit = 0, n = k - 1; n > 1; n /= 2)
+      depthLimit += 2;
+   introSort(a, 0, k - 2, depthLimit, less);
+}
+
+// FHtopK - streaming top-k.  keeps the k greatest items added so far in an
+// FHbinHeap whose top is the least of them: an item that doesn't make the
+// cut costs one comparison, one that does costs O(log k).  for the k least
+// items, pass a reversed comparator
+template <typename Comparable, typename Compare = FHless<Comparable> >
+class FHtopK
+{
+private:
+   int mK;
+   Compare mLess;
+   FHbinHeap<Comparable, 2, Compare> mHeap;
+
+public:
+   FHtopK(int k, Compare less = Compare())
+      : mK(k < 0 ? 0 : k), mLess(less), mHeap(k, less) { }
+
+   int size() const { return mHeap.size(); }
+   void add(const Comparable & x)
+   {
+      if (mHeap.size() < mK)
+         mHeap.insert(x);
+      else if (mK > 0 && mLess(mHeap.top(), x))
+         mHeap.replaceTop(x);
+   }
+
+   // the items kept so far, greatest first
+   void getResults(FHvector<Comparable> & result) const
+   {
+      FHbinHeap<Comparable, 2, Compare> heap(mHeap);
+      int k;
+
+      result.resize(heap.size());
+      for (k = heap.size() - 1; k >= 0; k--)
+         result[k] = heap.pop();
+   }
+};
+
+// the k greatest items of a, greatest first, in one pass over a
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void topK(const FHvector<Comparable> & a, int k, FHvector<Comparable> & result,
+   Compare less = Compare())
+{
+   FHtopK<Comparable, Compare> best(k, less);
+   int j;
+
+   for (j = 0; j < a.size(); j++)
+      best.add(a[j]);
+   best.getResults(result);
+}
+
+// radixSort helper: maps a numeric key to unsigned bits that sort in the
+// same order as the key.  signed ints have the sign bit flipped; IEEE
+// floats have the sign bit flipped if positive, every bit if negative
+// (so -0.0 sorts just before +0.0, and NaNs go to the ends)
+template <typename Key, bool IS_FLOAT = is_floating_point<Key>::value>
+class FHradixTraits
+{
+public:
+   typedef typename make_unsigned<Key>::type Bits;
+
+   static Bits bits(Key x)
+   {
+      Bits b = (Bits)x;
+
+      if (is_signed<Key>::value)
+         b ^= (Bits)1 << (8 * sizeof(Bits) - 1);
+      return b;
+   }
+};
+
+template <typename Key>
+class FHradixTraits<Key, true>
+{
+public:
+   typedef typename conditional<sizeof(Key) == 4,
+      unsigned int, unsigned long long>::type Bits;
+
+   static Bits bits(Key x)
+   {
+      static_assert(sizeof(Key) == sizeof(Bits),
+         "radixSort: only float and double floating keys");
+      const Bits SIGN = (Bits)1 << (8 * sizeof(Bits) - 1);
+      Bits b;
+
+      memcpy(&b, &x, sizeof(b));
+      return (b & SIGN) ? ~b : b ^ SIGN;
+   }
+};
+
+#define RADIX_SMALL_BITS 8    // digit size below RADIX_LARGE_SIZE items
+#define RADIX_LARGE_BITS 11   // fewer passes; 2048 counters still fit in L1
+#define RADIX_LARGE_SIZE 65536
+#define RADIX_PREFETCH_AHEAD 16   // items the scatter prefetches ahead
+
+// hint that *p is about to be written (no-op where unsupported)
+#if defined(__GNUC__)
+#define FH_PREFETCH_WRITE(p) __builtin_prefetch((p), 1)
+#else
+#define FH_PREFETCH_WRITE(p)
+#endif
+
+// radixSort - stable LSD radix sort on a numeric key.  getKey is any
+// function or functor taking a const Comparable & and returning an
+// integer or floating type, e.g.
+//    radixSort(tunes, [](const iTunesEntry & e) { return e.getTime(); });
+// each key is extracted once, all digit histograms are built in one read
+// of the keys, and passes where every key has the same digit are skipped.
+// the scatter prefetches the output slot of the item RADIX_PREFETCH_AHEAD
+// ahead, since consecutive items usually go to far-apart buckets
+template <typename Comparable, typename KeyFunc>
+void radixSort(FHvector<Comparable> & a, KeyFunc getKey)
+{
+   typedef typename decay<decltype(getKey(a[0]))>::type Key;
+   typedef typename FHradixTraits<Key>::Bits Bits;
+   const int KEY_BITS = 8 * sizeof(Bits);
+   int k, pass, digit, sum, tmp, numPasses, digitBits, numBuckets, mask;
+   int arraySize = a.size(), ahead;
+   bool inWorking = false;
+
+   if (arraySize < 2)
+      return;
+
+   digitBits = arraySize < RADIX_LARGE_SIZE ?
+      RADIX_SMALL_BITS : RADIX_LARGE_BITS;
+   numBuckets = 1 << digitBits;
+   mask = numBuckets - 1;
+   numPasses = (KEY_BITS + digitBits - 1) / digitBits;
+
+   FHvector<Bits> keys(arraySize), keysWorking(arraySize);
+   FHvector<Comparable> working(arraySize);
+   FHvector<int> counts(numPasses * numBuckets);
+
+   for (k = 0; k < numPasses * numBuckets; k++)
+      counts[k] = 0;
+   for (k = 0; k < arraySize; k++)
+   {
+      keys[k] = FHradixTraits<Key>::bits( getKey(a[k]) );
+      for (pass = 0; pass < numPasses; pass++)
+         counts[pass * numBuckets
+            + (int)(keys[k] >> (pass * digitBits) & mask)]++;
+   }
+
+   for (pass = 0; pass < numPasses; pass++)
+   {
+      FHvector<Comparable> & src = inWorking ? working : a;
+      FHvector<Comparable> & dst = inWorking ? a : working;
+      FHvector<Bits> & srcKeys = inWorking ? keysWorking : keys;
+      FHvector<Bits> & dstKeys = inWorking ? keys : keysWorking;
+      int *next = &counts[pass * numBuckets];
+
+      // every key has the same digit here: nothing would move
+      if (next[srcKeys[0] >> (pass * digitBits) & mask] == arraySize)
+         continue;
+
+      // counts become each bucket's first output position
+      for (digit = sum = 0; digit < numBuckets; digit++)
+      {
+         tmp = next[digit];
+         next[digit] = sum;
+         sum += tmp;
+      }
+
+      // scanning in order keeps equal digits in order - stable
+      for (k = 0; k < arraySize; k++)
+      {
+         ahead = k + RADIX_PREFETCH_AHEAD;
+         if (ahead < arraySize)
+         {
+            digit = (int)(srcKeys[ahead] >> (pass * digitBits) & mask);
+            FH_PREFETCH_WRITE(dst.begin() + next[digit]);
+            FH_PREFETCH_WRITE(dstKeys.begin() + next[digit]);
+         }
+         digit = (int)(srcKeys[k] >> (pass * digitBits) & mask);
+         dstKeys[next[digit]] = srcKeys[k];
+         dst[next[digit]++] = std::move(src[k]);
+      }
+      inWorking = !inWorking;
+   }
+
+   if (inWorking)
+      for (k = 0; k < arraySize; k++)
+         a[k] = std::move(working[k]);
+}
+
+// version for vectors of numbers, sorted by their own value
+template <typename Comparable>
+void radixSort(FHvector<Comparable> & a)
+{
+   radixSort(a, [](const Comparable & x) { return x; });
+}
+
+// moves the client elements so that a[k] becomes the old a[order[k]].
+// follows each cycle of the permutation once, so every element is moved
+// only once.  order is left as the identity.  used by indirectSort,
+// keySort and stringSort to untangle the client array after sorting.
+// a is the start of the client range: an FHvector iterator, a raw
+// pointer, ...  (order.size() elements)
+template <typename Iterator>
+void applyOrder(Iterator a, FHvector<int> & order)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int k, j, nextJ, arraySize = order.size();
+   Comparable tmp;
+
+   for (k = 0; k < arraySize; k++)
+      if (order[k] != k)
+      {
+         tmp = std::move(a[k]);
+         for (j = k; order[j] != k; j = nextJ)
+         {
+            nextJ = order[j];
+            a[j] = std::move(a[nextJ]);
+            order[j] = j;
+         }
+         a[j] = std::move(tmp);
+         order[j] = j;
+      }
+}
+
+template <typename Comparable>
+void applyOrder(FHvector<Comparable> & a, FHvector<int> & order)
+{
+   applyOrder(a.begin(), order);
+}
+
+// stringSort helper: one string key, seen as raw chars, and the index of
+// the client element it came from
+class FHstringSortItem
+{
+public:
+   const char *str;
+   int len, index;
+
+   // characters as 1 .. 256, with 0 past the end of the string, so a
+   // string sorts before any longer string it is a prefix of
+   int charAt(int depth) const
+   {
+      return depth < len ? (unsigned char)str[depth] + 1 : 0;
+   }
+};
+
+#define MKQS_CUTOFF 16   // insertion sort below this many strings
+
+// stringSort helper: insertion sort of items that all share their first
+// depth characters, so comparisons start at depth
+inline void stringInsertionSort(FHvector<FHstringSortItem> & items,
+   int left, int right, int depth)
+{
+   int k, pos, d;
+   FHstringSortItem tmp;
+
+   for (pos = left + 1; pos <= right; pos++)
+   {
+      tmp = items[pos];
+      for (k = pos; k > left; k--)
+      {
+         for (d = depth; tmp.charAt(d) == items[k - 1].charAt(d)
+            && tmp.charAt(d) != 0; d++)
+            ;
+         if ( !(tmp.charAt(d) < items[k - 1].charAt(d)) )
+            break;
+         items[k] = items[k - 1];
+      }
+      items[k] = tmp;
+   }
+}
+
+// stringSort internal: Bentley-Sedgewick multikey quicksort.  all items in
+// [left, right] share their first depth characters.  they are partitioned
+// three ways on the character at depth, and only the middle group moves on
+// to depth + 1, so no character of a known common prefix is looked at again
+inline void stringSort(FHvector<FHstringSortItem> & items, int left,
+   int right, int depth)
+{
+   int lt, gt, k, pivot, c, center;
+
+   while (right - left >= MKQS_CUTOFF)
+   {
+      // median of three characters, moved to items[left]
+      center = (left + right) / 2;
+      if (items[center].charAt(depth) < items[left].charAt(depth))
+         mySwapFH(items[center], items[left]);
+      if (items[right].charAt(depth) < items[left].charAt(depth))
+         mySwapFH(items[right], items[left]);
+      if (items[right].charAt(depth) < items[center].charAt(depth))
+         mySwapFH(items[right], items[center]);
+      mySwapFH(items[center], items[left]);
+      pivot = items[left].charAt(depth);
+
+      // items[left..lt-1] < pivot, items[gt+1..right] > pivot
+      lt = left;
+      gt = right;
+      for (k = left + 1; k <= gt; )
+      {
+         c = items[k].charAt(depth);
+         if (c < pivot)
+            mySwapFH(items[lt++], items[k++]);
+         else if (c > pivot)
+            mySwapFH(items[k], items[gt--]);
+         else
+            k++;
+      }
+
+      stringSort(items, left, lt - 1, depth);
+      stringSort(items, gt + 1, right, depth);
+
+      // the middle group ended together (pivot 0): nothing left to compare
+      if (pivot == 0)
+         return;
+      left = lt;
+      right = gt;
+      depth++;
+   }
+
+   if (left < right)
+      stringInsertionSort(items, left, right, depth);
+}
+
+// stringSort - sorts on a string key.  getKey takes a const Comparable &
+// and returns a string, e.g.
+//    stringSort(books, [](const EBookEntry & b) { return b.getTitle(); });
+// the keys are extracted once, sorted by multikey quicksort, and then the
+// client elements are moved into place.  not stable (like quickSort)
+template <typename Comparable, typename KeyFunc>
+void stringSort(FHvector<Comparable> & a, KeyFunc getKey)
+{
+   int k, arraySize = a.size();
+   FHvector<string> keys(arraySize);
+   FHvector<FHstringSortItem> items(arraySize);
+   FHvector<int> order(arraySize);
+
+   if (arraySize < 2)
+      return;
+
+   for (k = 0; k < arraySize; k++)
+   {
+      keys[k] = getKey(a[k]);
+      items[k].str = keys[k].data();
+      items[k].len = keys[k].size();
+      items[k].index = k;
+   }
+   stringSort(items, 0, arraySize - 1, 0);
+
+   for (k = 0; k < arraySize; k++)
+      order[k] = items[k].index;
+   applyOrder(a, order);
+}
+
+// version for vectors of strings
+template <typename Comparable>
+void stringSort(FHvector<Comparable> & a)
+{
+   int k, arraySize = a.size();
+   FHvector<FHstringSortItem> items(arraySize);
+   FHvector<int> order(arraySize);
+
+   if (arraySize < 2)
+      return;
+
+   for (k = 0; k < arraySize; k++)
+   {
+      items[k].str = a[k].data();
+      items[k].len = a[k].size();
+      items[k].index = k;
+   }
+   stringSort(items, 0, arraySize - 1, 0);
+
+   for (k = 0; k < arraySize; k++)
+      order[k] = items[k].index;
+   applyOrder(a, order);
+}
+
+// smart pointer for indirect sort
+template <typename Comparable>
+class SmartPointer
+{
+private:
+   Comparable *pointee;
+
+public:
+   Comparable * operator=(Comparable *rhs);
+   SmartPointer<Comparable> & operator=(const SmartPointer<Comparable>  &rhs);
+   bool operator<( const SmartPointer<Comparable> & rhs ) const;
+   bool operator!=(const SmartPointer<Comparable> & rhs) const;
+   bool operator!=(const Comparable *rhs) const;
+   int operator-(const Comparable *rhs) const;
+   const Comparable & operator*() const  { return *pointee; }
+};
+
+// SmartPointer method definitions ----------------
+template <typename Comparable>
+Comparable * SmartPointer<Comparable>::operator=(Comparable *rhs)
+{
+   return (pointee = rhs);
+}
+
+template <typename Comparable>
+SmartPointer<Comparable> & SmartPointer<Comparable>::operator=(
+   const SmartPointer<Comparable>  &rhs)
+{
+   pointee = rhs.pointee;
+   return *this;
+}
+
+template <typename Comparable>
+bool SmartPointer<Comparable>::operator<( const SmartPointer<Comparable> & rhs ) const
+{
+   return *pointee < *rhs.pointee;
+}
+
+template <typename Comparable>
+bool SmartPointer<Comparable>::operator!=(const SmartPointer<Comparable> & rhs) const
+{
+   return pointee != rhs.pointee;
+}
+
+template <typename Comparable>
+bool SmartPointer<Comparable>::operator!=(const Comparable *rhs) const
+{
+   return pointee != rhs;
+}
+
+template <typename Comparable>
+int SmartPointer<Comparable>::operator-(const Comparable *rhs) const
+{
+   return pointee - rhs;
+}
+
+// indirect sort - uses SmartPointer as intermediate type
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void indirectSort( FHvector<Comparable> & a, Compare less = Compare() )
+{
+   int k, arraySize = a.size();
+   FHvector< SmartPointer<Comparable> > p(arraySize);
+   FHvector<int> order(arraySize);
+
+   // copy smart pointer to the client array
+   for( k = 0; k < arraySize; k++ )
+      p[k] = &a[k];
+
+   // do the sort - it only changes the smart pointer order
+   quickSort(p, [&less](const SmartPointer<Comparable> & x,
+      const SmartPointer<Comparable> & y) { return less(*x, *y); });
+
+   // untangle the client elements so they match the pointer order
+   for( k = 0; k < arraySize; k++ )
+      order[k] = p[k] - &a[0];
+   applyOrder(a, order);
+}
+
+// keySort helper: one cached key and the index of its client element
+template <typename Key>
+class FHkeyIndex
+{
+public:
+   Key key;
+   int index;
+};
+
+// keySort - decorate, sort, undecorate.  getKey(a[k]) is called exactly
+// once per element; the (key, index) pairs are sorted, and the client
+// elements are then moved into place by applyOrder.  use it when keys are
+// expensive to compute or compare through the full record, e.g.
+//    keySort(tunes, [](const iTunesEntry & t)
+//       { return t.getArtistLastName() + t.getArtist(); });
+// keys are ordered by lessKey (default: the key's operator<).  stable
+template <typename Comparable, typename KeyFunc, typename KeyCompare>
+void keySort(FHvector<Comparable> & a, KeyFunc getKey, KeyCompare lessKey)
+{
+   typedef typename decay<decltype(getKey(a[0]))>::type Key;
+   int k, arraySize = a.size();
+   FHvector< FHkeyIndex<Key> > items(arraySize);
+   FHvector<int> order(arraySize);
+
+   if (arraySize < 2)
+      return;
+
+   for (k = 0; k < arraySize; k++)
+   {
+      items[k].key = getKey(a[k]);
+      items[k].index = k;
+   }
+   mergeSortBottomUp(items, [&lessKey](const FHkeyIndex<Key> & x,
+      const FHkeyIndex<Key> & y) { return lessKey(x.key, y.key); });
+
+   for (k = 0; k < arraySize; k++)
+      order[k] = items[k].index;
+   applyOrder(a, order);
+}
+
+template <typename Comparable, typename KeyFunc>
+void keySort(FHvector<Comparable> & a, KeyFunc getKey)
+{
+   typedef typename decay<decltype(getKey(a[0]))>::type Key;
+
+   keySort(a, getKey, FHless<Key>());
+}
+
+#endif
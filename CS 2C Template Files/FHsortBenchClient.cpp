@@ -0,0 +1,549 @@
+// Client for comparing the FHsort.h sorts.  Every sort runs on every input
+// distribution and item type at sizes 1000, 10000, ... up to a maximum,
+// and prints one CSV line per run:
+//    sort,type,distribution,size,nsPerItem,comparisons,moves,peakBytes
+// nsPerItem is the best of up to MAX_TIMED_RUNS timed sorts of the same
+// input.  comparisons and moves (item copies, moves and assignments) come
+// from one more sort of the input with every item in an FHcounted.
+// peakBytes is the most heap the sort had allocated at once.
+//
+//    FHsortBench [maxSize [sortName]]
+// maxSize defaults to 1000000; sortName runs only the sorts whose name
+// contains it.  Build with the record classes:
+//    g++ -O2 -pthread FHsortBenchClient.cpp EBookEntry.cpp iTunes.cpp
+//       StarNearEarth.cpp -o FHsortBench
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <random>
+using namespace std;
+
+#include "FHsort.h"
+#include "FHparallelSort.h"
+#include "FHcounted.h"
+#include "EBookEntry.h"
+#include "iTunes.h"
+#include "StarNearEarth.h"
+
+#define MIN_SIZE 1000
+#define DEFAULT_MAX_SIZE 1000000
+#define QUADRATIC_MAX_SIZE 10000   // insertionSort stops here
+#define MAX_TIMED_RUNS 5
+#define MIN_TIMED_SECONDS 0.1      // fewer runs once this much is timed
+#define MAX_KEY 10000000           // keys are 0 .. MAX_KEY - 1
+#define FEW_UNIQUE_KEYS 16
+#define ZIPF_RANKS 100000
+
+// ---------------- heap tracking, for peakBytes --------------------
+// every block is allocated with a header holding its size
+#define HEAP_HEADER 16
+
+static atomic<long long> heapBytes(0), heapPeak(0);
+
+void *operator new(size_t size)
+{
+   char *block = (char *)malloc(size + HEAP_HEADER);
+   long long now, peak;
+
+   if (block == NULL)
+      throw bad_alloc();
+   *(size_t *)block = size;
+   now = heapBytes += size;
+   peak = heapPeak.load();
+   while (now > peak && !heapPeak.compare_exchange_weak(peak, now))
+      ;
+   return block + HEAP_HEADER;
+}
+
+void operator delete(void *p) noexcept
+{
+   char *block;
+
+   if (p == NULL)
+      return;
+   block = (char *)p - HEAP_HEADER;
+   heapBytes -= *(size_t *)block;
+   free(block);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+   try
+   {
+      return operator new(size);
+   }
+   catch (bad_alloc &)
+   {
+      return NULL;
+   }
+}
+
+void operator delete(void *p, const nothrow_t &) noexcept
+{
+   operator delete(p);
+}
+
+// sized and array forms all come through the two above, so every block
+// has its header
+void operator delete(void *p, size_t) noexcept
+{
+   operator delete(p);
+}
+
+void *operator new[](size_t size)
+{
+   return operator new(size);
+}
+
+void operator delete[](void *p) noexcept
+{
+   operator delete(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+   operator delete(p);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+   return operator new(size, nothrow);
+}
+
+void operator delete[](void *p, const nothrow_t &) noexcept
+{
+   operator delete(p);
+}
+
+// ---------------- item types ----------------------------------------
+// BenchItem<T> makes a T from a key, and names the comparator and the
+// key-based sort (radixSort or stringSort) used for T.  getItem gets the
+// T out of whatever is being sorted: the T itself, or an FHcounted<T>
+string paddedKey(int key)
+{
+   char buf[16];
+
+   sprintf(buf, "%08d", key);
+   return buf;
+}
+
+template <class T>
+class BenchItem;
+
+template <>
+class BenchItem<int>
+{
+public:
+   typedef FHless<int> Less;
+   static const char *name() { return "int"; }
+   static const char *keySortName() { return "radixSort"; }
+   static int make(int key) { return key; }
+
+   template <class Item, class GetItem>
+   static void keySort(FHvector<Item> & a, GetItem getItem)
+   {
+      radixSort(a, [getItem](const Item & x) { return getItem(x); });
+   }
+};
+
+template <>
+class BenchItem<double>
+{
+public:
+   typedef FHless<double> Less;
+   static const char *name() { return "double"; }
+   static const char *keySortName() { return "radixSort"; }
+   static double make(int key) { return key * 0.001; }
+
+   template <class Item, class GetItem>
+   static void keySort(FHvector<Item> & a, GetItem getItem)
+   {
+      radixSort(a, [getItem](const Item & x) { return getItem(x); });
+   }
+};
+
+template <>
+class BenchItem<string>
+{
+public:
+   typedef FHless<string> Less;
+   static const char *name() { return "string"; }
+   static const char *keySortName() { return "stringSort"; }
+   static string make(int key) { return paddedKey(key); }
+
+   template <class Item, class GetItem>
+   static void keySort(FHvector<Item> & a, GetItem getItem)
+   {
+      stringSort(a, [getItem](const Item & x) { return getItem(x); });
+   }
+};
+
+template <>
+class BenchItem<EBookEntry>
+{
+public:
+   typedef EBookEntry::ByTitle Less;
+   static const char *name() { return "EBookEntry"; }
+   static const char *keySortName() { return "stringSort"; }
+   static EBookEntry make(int key)
+   {
+      EBookEntry book;
+
+      book.setTitle("Title " + paddedKey(key));
+      book.setCreator("Creator " + paddedKey(key % 1000));
+      book.setSubject("Subject " + paddedKey(key % 100));
+      book.SetNEtextNum(1 + key % EBookEntry::MAX_ID);
+      return book;
+   }
+
+   template <class Item, class GetItem>
+   static void keySort(FHvector<Item> & a, GetItem getItem)
+   {
+      stringSort(a, [getItem](const Item & x)
+         { return getItem(x).getTitle(); });
+   }
+};
+
+template <>
+class BenchItem<iTunesEntry>
+{
+public:
+   typedef iTunesEntry::ByTime Less;
+   static const char *name() { return "iTunesEntry"; }
+   static const char *keySortName() { return "radixSort"; }
+   static iTunesEntry make(int key)
+   {
+      iTunesEntry tune;
+
+      tune.setTitle("Title " + paddedKey(key));
+      tune.setArtist("Artist " + paddedKey(key % 1000));
+      tune.setTime(key);
+      return tune;
+   }
+
+   template <class Item, class GetItem>
+   static void keySort(FHvector<Item> & a, GetItem getItem)
+   {
+      radixSort(a, [getItem](const Item & x)
+         { return getItem(x).getTime(); });
+   }
+};
+
+template <>
+class BenchItem<StarNearEarth>
+{
+public:
+   typedef StarNearEarth::ByMass Less;
+   static const char *name() { return "StarNearEarth"; }
+   static const char *keySortName() { return "radixSort"; }
+   static StarNearEarth make(int key)
+   {
+      StarNearEarth star;
+
+      star.setNameCns("Star " + paddedKey(key));
+      star.setMass(key / 100000.);
+      return star;
+   }
+
+   template <class Item, class GetItem>
+   static void keySort(FHvector<Item> & a, GetItem getItem)
+   {
+      radixSort(a, [getItem](const Item & x)
+         { return getItem(x).getMass(); });
+   }
+};
+
+// ---------------- input distributions -------------------------------
+enum { RANDOM, SORTED, REVERSED, FEW_UNIQUE, ORGAN_PIPE, ZIPF,
+   NUM_DISTRIBUTIONS };
+const char *distributionNames[NUM_DISTRIBUTIONS] =
+   { "random", "sorted", "reversed", "fewUnique", "organPipe", "zipf" };
+
+// n keys in 0 .. MAX_KEY - 1.  zipf: key of rank r has probability
+// proportional to 1/r, and the ranks are scattered over the key range
+void makeKeys(int distribution, int n, FHvector<int> & keys)
+{
+   static mt19937 gen(1);
+   uniform_int_distribution<int> anyKey(0, MAX_KEY - 1);
+   uniform_real_distribution<double> uniform(0, 1);
+   FHvector<double> cdf;
+   double target;
+   int k, lo, hi;
+
+   keys.resize(n);
+   if (distribution == ZIPF)
+   {
+      cdf.resize(ZIPF_RANKS);
+      for (k = 0; k < ZIPF_RANKS; k++)
+         cdf[k] = (k > 0 ? cdf[k - 1] : 0) + 1. / (k + 1);
+   }
+
+   for (k = 0; k < n; k++)
+      switch (distribution)
+      {
+      case RANDOM:
+         keys[k] = anyKey(gen);
+         break;
+      case SORTED:
+         keys[k] = (int)((long long)k * MAX_KEY / n);
+         break;
+      case REVERSED:
+         keys[k] = (int)((long long)(n - 1 - k) * MAX_KEY / n);
+         break;
+      case FEW_UNIQUE:
+         keys[k] = (int)(gen() % FEW_UNIQUE_KEYS) * (MAX_KEY / FEW_UNIQUE_KEYS);
+         break;
+      case ORGAN_PIPE:
+         keys[k] = (int)((long long)(k < n / 2 ? k : n - 1 - k) * MAX_KEY / n);
+         break;
+      case ZIPF:
+         // binary search of the cdf for a uniform draw
+         target = uniform(gen) * cdf[ZIPF_RANKS - 1];
+         for (lo = 0, hi = ZIPF_RANKS - 1; lo < hi; )
+            if (cdf[(lo + hi) / 2] < target)
+               lo = (lo + hi) / 2 + 1;
+            else
+               hi = (lo + hi) / 2;
+         keys[k] = (int)((long long)lo * 2654435761LL % MAX_KEY);
+         break;
+      }
+}
+
+// ---------------- the sorts -----------------------------------------
+enum { INSERTION, SHELL1, SHELL_CIURA, SHELL_TOKUDA, SHELL_SEDGEWICK, MERGE,
+   MERGE_BOTTOM_UP, TIM, HEAP, HEAP_BOTTOM_UP, QUICK, INTRO, BLOCK_QUICK,
+   QUICK_3WAY, INDIRECT, PARALLEL_MERGE, PARALLEL_QUICK, PARALLEL_SHELL,
+   PARALLEL_HEAP, BY_KEY, NUM_SORTS };
+const char *sortNames[NUM_SORTS] = { "insertionSort", "shellSort1",
+   "shellSortCiura", "shellSortTokuda", "shellSortSedgewick", "mergeSort",
+   "mergeSortBottomUp", "timSort", "heapSort", "heapSortBottomUp",
+   "quickSort", "introSort", "blockQuickSort", "quickSort3Way", "indirectSort",
+   "parallelMergeSort", "parallelQuickSort", "parallelShellSort",
+   "parallelHeapSort", NULL };
+
+// BY_KEY is radixSort or stringSort, depending on T
+template <class T>
+const char *sortName(int sort)
+{
+   return sort == BY_KEY ? BenchItem<T>::keySortName() : sortNames[sort];
+}
+
+template <class T, class Item, class Compare, class GetItem>
+void runSort(int sort, FHvector<Item> & a, Compare less, GetItem getItem,
+   FHthreadPool & pool)
+{
+   switch (sort)
+   {
+   case INSERTION:       insertionSort(a, less); break;
+   case SHELL1:          shellSort1(a, less); break;
+   case SHELL_CIURA:     shellSort(a, CIURA_GAPS, less); break;
+   case SHELL_TOKUDA:    shellSort(a, TOKUDA_GAPS, less); break;
+   case SHELL_SEDGEWICK: shellSort(a, SEDGEWICK_GAPS, less); break;
+   case MERGE:           mergeSort(a, less); break;
+   case MERGE_BOTTOM_UP: mergeSortBottomUp(a, less); break;
+   case TIM:             timSort(a, less); break;
+   case HEAP:            heapSort(a, less); break;
+   case HEAP_BOTTOM_UP:  heapSortBottomUp(a, less); break;
+   case QUICK:           quickSort(a, less); break;
+   case INTRO:           introSort(a, less); break;
+   case BLOCK_QUICK:     blockQuickSort(a, less); break;
+   case QUICK_3WAY:      quickSort3Way(a, less); break;
+   case INDIRECT:        indirectSort(a, less); break;
+   case PARALLEL_MERGE:  parallelMergeSort(a, pool, less); break;
+   case PARALLEL_QUICK:  parallelQuickSort(a, pool, less); break;
+   case PARALLEL_SHELL:  parallelShellSort(a, pool, DEFAULT_GAPS, less); break;
+   case PARALLEL_HEAP:   parallelHeapSort(a, pool, less); break;
+   case BY_KEY:          BenchItem<T>::keySort(a, getItem); break;
+   }
+}
+
+template <class Item, class Compare>
+bool isSorted(const FHvector<Item> & a, Compare less)
+{
+   int k;
+
+   for (k = 1; k < a.size(); k++)
+      if (less(a[k], a[k - 1]))
+         return false;
+   return true;
+}
+
+// times one sort on one input and prints its CSV line
+template <class T>
+void benchSort(int sort, int distribution, const FHvector<T> & input,
+   FHthreadPool & pool)
+{
+   typedef typename BenchItem<T>::Less Less;
+   FHvector<T> a;
+   FHvector< FHcounted<T> > counted(input.size());
+   FHcounts used;
+   double seconds, best, total;
+   long long peakBytes = 0;
+   int k, run;
+
+   auto getItem = [](const T & x) -> const T & { return x; };
+   auto getCounted = [](const FHcounted<T> & x) -> const T &
+      { return x.item(); };
+
+   for (run = 0, best = total = 0; run < MAX_TIMED_RUNS
+      && (run == 0 || total < MIN_TIMED_SECONDS); run++)
+   {
+      a = input;
+      heapPeak = heapBytes.load();
+      auto start = chrono::steady_clock::now();
+      runSort<T>(sort, a, Less(), getItem, pool);
+      auto stop = chrono::steady_clock::now();
+
+      seconds = chrono::duration<double>(stop - start).count();
+      total += seconds;
+      if (run == 0 || seconds < best)
+         best = seconds;
+      if (run == 0)
+      {
+         peakBytes = heapPeak - heapBytes;
+         if (!isSorted(a, Less()))
+            cerr << "error: " << sortName<T>(sort) << " did not sort "
+               << BenchItem<T>::name() << endl;
+      }
+   }
+
+   for (k = 0; k < input.size(); k++)
+      counted[k] = FHcounted<T>(input[k]);
+   used = FHcounts::total();
+   runSort<T>(sort, counted, FHcountedCompare<Less>(), getCounted, pool);
+   used = FHcounts::total() - used;
+
+   cout << sortName<T>(sort) << "," << BenchItem<T>::name() << ","
+      << distributionNames[distribution] << "," << input.size() << ","
+      << best * 1e9 / input.size() << "," << used.compares << ","
+      << used.transfers() << "," << peakBytes << endl;
+}
+
+template <class T>
+void benchType(int maxSize, const char *sortFilter, FHthreadPool & pool)
+{
+   FHvector<int> keys;
+   FHvector<T> input;
+   int n, k, distribution, sort;
+
+   for (n = MIN_SIZE; n <= maxSize; n *= 10)
+      for (distribution = 0; distribution < NUM_DISTRIBUTIONS; distribution++)
+      {
+         makeKeys(distribution, n, keys);
+         input.resize(n);
+         for (k = 0; k < n; k++)
+            input[k] = BenchItem<T>::make(keys[k]);
+
+         for (sort = 0; sort < NUM_SORTS; sort++)
+         {
+            if (sort == INSERTION && n > QUADRATIC_MAX_SIZE)
+               continue;
+            if (sortFilter != NULL
+               && strstr(sortName<T>(sort), sortFilter) == NULL)
+               continue;
+            benchSort(sort, distribution, input, pool);
+         }
+      }
+}
+
+// the versions that sort a[left] ... a[right] only, run with an item
+// before the range that is greater than all of it and one after that is
+// less.  errors go to cerr, like the full sorts'
+void checkSubranges()
+{
+   const int sorts[] = { INSERTION, TIM, HEAP, HEAP_BOTTOM_UP, QUICK, INTRO,
+      BLOCK_QUICK };
+   const int numSorts = sizeof(sorts) / sizeof(sorts[0]);
+   const int size = 1000, left = 1, right = size - 2, depthLimit = 20;
+   FHvector<int> keys(size), a;
+   FHless<int> less;
+   mt19937 gen(2);
+   int j, k;
+   bool ok;
+
+   for (k = 0; k < size; k++)
+      keys[k] = gen() % MAX_KEY;
+   keys[0] = MAX_KEY;
+   keys[size - 1] = -1;
+   for (j = 0; j < numSorts; j++)
+   {
+      a = keys;
+      switch (sorts[j])
+      {
+      case INSERTION:      insertionSort(a, left, right, less); break;
+      case TIM:            timSort(a, left, right, less); break;
+      case HEAP:           heapSort(a, left, right, less); break;
+      case HEAP_BOTTOM_UP: heapSortBottomUp(a, left, right, less); break;
+      case QUICK:          quickSort(a, left, right, less); break;
+      case INTRO:          introSort(a, left, right, depthLimit, less); break;
+      case BLOCK_QUICK:
+         blockQuickSort(a, left, right, depthLimit, less);
+         break;
+      }
+
+      ok = a[0] == keys[0] && a[size - 1] == keys[size - 1];
+      for (k = left + 1; k <= right; k++)
+         if (a[k] < a[k - 1])
+            ok = false;
+      if (!ok)
+         cerr << "error: " << sortNames[sorts[j]]
+            << " did not sort a subrange" << endl;
+   }
+}
+
+// --------------- main ---------------
+int main(int argc, char *argv[])
+{
+   int maxSize = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_SIZE;
+   const char *sortFilter = argc > 2 ? argv[2] : NULL;
+   FHthreadPool pool;
+
+   checkSubranges();
+   cout << "sort,type,distribution,size,nsPerItem,comparisons,moves,"
+      "peakBytes" << endl;
+   benchType<int>(maxSize, sortFilter, pool);
+   benchType<double>(maxSize, sortFilter, pool);
+   benchType<string>(maxSize, sortFilter, pool);
+   benchType<EBookEntry>(maxSize, sortFilter, pool);
+   benchType<iTunesEntry>(maxSize, sortFilter, pool);
+   benchType<StarNearEarth>(maxSize, sortFilter, pool);
+   return 0;
+}
+
+/* --------------- Sample Run (g++ -O2, FHsortBench 10000) ----------------
+
+sort,type,distribution,size,nsPerItem,comparisons,moves,peakBytes
+insertionSort,int,random,10000,15824.9,24960037,24970050,0
+shellSort1,int,random,10000,200.112,269143,394209,0
+shellSortCiura,int,random,10000,139.67,190436,290805,0
+shellSortTokuda,int,random,10000,150.454,193933,298086,0
+shellSortSedgewick,int,random,10000,116.875,231627,300144,0
+mergeSort,int,random,10000,188.79,120471,267232,40064
+mergeSortBottomUp,int,random,10000,125.225,171734,196385,40064
+timSort,int,random,10000,185.236,120397,199866,30832
+heapSort,int,random,10000,161.222,235292,174192,0
+heapSortBottomUp,int,random,10000,118.091,136620,182670,0
+quickSort,int,random,10000,93.7077,144804,115695,0
+introSort,int,random,10000,97.6214,144804,115695,0
+blockQuickSort,int,random,10000,41.1749,144321,117479,0
+quickSort3Way,int,random,10000,110.758,215201,119681,0
+indirectSort,int,random,10000,103.192,144804,10009,120192
+parallelMergeSort,int,random,10000,132.621,171734,196385,40064
+parallelQuickSort,int,random,10000,100.101,144804,115695,0
+parallelShellSort,int,random,10000,116.995,231627,300144,0
+parallelHeapSort,int,random,10000,117.693,136620,182670,0
+radixSort,int,random,10000,28.355,0,40000,124352
+...
+timSort,EBookEntry,zipf,10000,639.578,113972,194420,1453024
+introSort,EBookEntry,zipf,10000,673.708,131592,115974,96
+blockQuickSort,EBookEntry,zipf,10000,368.894,115563,83341,62
+indirectSort,EBookEntry,zipf,10000,198.428,131592,10006,120192
+stringSort,EBookEntry,zipf,10000,147.823,0,10005,520840
+...
+
+------------------------------------------- */
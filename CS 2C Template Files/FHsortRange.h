@@ -0,0 +1,698 @@
+// File FHsortRange.h
+// Template definitions for iterator range versions of the FHsort.h sorts.
+// Each sorts [first, last) of any random access iterators - raw pointers,
+// FHvector or std::vector iterators, a memory-mapped array, ... - in place,
+// so the client doesn't have to copy into an FHvector first:
+//    introSort(array, array + arraySize);
+//    mergeSort(books.begin(), books.end(), EBookEntry::ByTitle());
+// The comparator is optional, as in FHsort.h (see FHcompare.h).  Sorts
+// that need an O(n) working array anyway (mergeSortBottomUp, timSort,
+// radixSort) move the range into one and back.
+#ifndef FHSORTRANGE_H
+#define FHSORTRANGE_H
+#include "FHsort.h"
+#include <iterator>
+using namespace std;
+
+// the default comparator for a range: operator< on its items
+template <typename Iterator>
+using FHrangeLess = FHless<typename iterator_traits<Iterator>::value_type>;
+
+// moves [first, last) into v
+template <typename Iterator>
+void rangeToVector(Iterator first, Iterator last,
+   FHvector<typename iterator_traits<Iterator>::value_type> & v)
+{
+   int k, arraySize = last - first;
+
+   v.resize(arraySize);
+   for (k = 0; k < arraySize; k++)
+      v[k] = std::move(first[k]);
+}
+
+// moves v back to the range starting at first
+template <typename Comparable, typename Iterator>
+void vectorToRange(FHvector<Comparable> & v, Iterator first)
+{
+   int k;
+
+   for (k = 0; k < v.size(); k++)
+      first[k] = std::move(v[k]);
+}
+
+// shellSort #1 -- using shell's outer loop
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void shellSort1(Iterator first, Iterator last, Compare less = Compare())
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int k, pos, gap, arraySize = last - first;
+   Comparable tmp;
+
+   for (gap = arraySize/2;  gap > 0;  gap /= 2)
+      for(pos = gap ; pos < arraySize; pos++ )
+      {
+         tmp = std::move(first[pos]);
+         for(k = pos; k >= gap && less(tmp, first[k - gap]); k -= gap )
+            first[k] = std::move(first[k - gap]);
+         first[k] = std::move(tmp);
+      }
+}
+
+// shellSort with a choice of gap sequence (see FHsort.h)
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void shellSort(Iterator first, Iterator last, FHgapSequence gaps,
+   Compare less = Compare())
+{
+   shellSort(first, last - first, gaps, less);
+}
+
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void shellSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   shellSort(first, last - first, DEFAULT_GAPS, less);
+}
+
+// mergesort helper: merges [first, mid) with [mid, last) using working.
+// only the items up to where the right run is used up go through
+// working; the rest of the right run is already in place.  (not named
+// merge, which would clash with std::merge for pointer ranges)
+template <typename Iterator, typename Comparable, typename Compare>
+void mergeRange(Iterator first, Iterator mid, Iterator last,
+   Comparable *working, Compare less)
+{
+   Iterator leftPos = first, rightPos = mid;
+   Comparable *workingPos = working, *k;
+
+   // ties go to the left run, which keeps the sort stable
+   while (leftPos != mid && rightPos != last)
+      if ( !less(*rightPos, *leftPos) )
+         *workingPos++ = std::move(*leftPos++);
+      else
+         *workingPos++ = std::move(*rightPos++);
+   while (leftPos != mid)
+      *workingPos++ = std::move(*leftPos++);
+
+   for (k = working; k != workingPos; k++)
+      *first++ = std::move(*k);
+}
+
+// mergesort internal
+template <typename Iterator, typename Comparable, typename Compare>
+void mergeSort(Iterator first, Iterator last, Comparable *working,
+   Compare less)
+{
+   Iterator mid;
+
+   if (last - first < 2)
+      return;
+
+   mid = first + (last - first) / 2;
+   mergeSort(first, mid, working, less);
+   mergeSort(mid, last, working, less);
+   mergeRange(first, mid, last, working, less);
+}
+
+// mergesort public driver - stable
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void mergeSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+
+   if (last - first < 2)
+      return;
+
+   FHvector<Comparable> working(last - first);
+   mergeSort(first, last, &working[0], less);
+}
+
+// bottom-up mergesort - stable
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void mergeSortBottomUp(Iterator first, Iterator last, Compare less = Compare())
+{
+   FHvector<typename iterator_traits<Iterator>::value_type> a;
+
+   rangeToVector(first, last, a);
+   mergeSortBottomUp(a, less);
+   vectorToRange(a, first);
+}
+
+// timSort - stable; close to O(n) on nearly sorted data
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void timSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   FHvector<typename iterator_traits<Iterator>::value_type> a;
+
+   rangeToVector(first, last, a);
+   timSort(a, less);
+   vectorToRange(a, first);
+}
+
+// heapSort helper: max heap of first[0] ... first[arraySize - 1]
+template <typename Iterator, typename Compare>
+void percolateDown(Iterator first, int hole, int arraySize, Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int child;
+   Comparable tmp;
+
+   for( tmp = std::move(first[hole]); 2 * hole + 1 < arraySize; hole = child )
+   {
+      child = 2 * hole + 1;
+      // if 2 children, get the GREATER of the two (because MAX heap)
+      if( child < arraySize - 1 && less(first[child], first[child + 1]))
+         child++;
+      if( less(tmp, first[child]) )   // MAX heap, not min heap
+         first[hole] = std::move(first[child]);
+      else
+         break;
+   }
+   first[hole] = std::move(tmp);
+}
+
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void heapSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   int k, arraySize = last - first;
+
+   for(k = arraySize/2 - 1; k >= 0; k-- )
+      percolateDown(first, k, arraySize, less);
+
+   for(k = arraySize - 1; k > 0; k-- )
+   {
+      mySwapFH(first[0], first[k]);
+      percolateDown(first, 0, k, less);
+   }
+}
+
+// heapSortBottomUp - heapSort with about half the comparisons (FHsort.h)
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void heapSortBottomUp(Iterator first, Iterator last, Compare less = Compare())
+{
+   heapSortBottomUp(first, last - first, less);
+}
+
+// quickSort helper
+// median3 sorts *first, the center item and last[-1], then moves the
+// median (the pivot) "out-of-the-way" to last[-2].  returns its position
+template <typename Iterator, typename Compare>
+Iterator median3(Iterator first, Iterator last, Compare less)
+{
+   Iterator center = first + (last - first - 1) / 2, right = last - 1;
+
+   if(less(*center, *first))
+      mySwapFH(*first, *center);
+   if(less(*right, *first))
+      mySwapFH(*first, *right);
+   if(less(*right, *center))
+      mySwapFH(*center, *right);
+
+   mySwapFH(*center, *(right - 1));
+   return right - 1;
+}
+
+// quickSort helper
+// partitions [first, last) around the median3 pivot and returns the
+// pivot's final position: nothing before it is greater, nothing after less
+template <typename Iterator, typename Compare>
+Iterator quickSortPartition(Iterator first, Iterator last, Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   Comparable pivot;
+   Iterator i, j;
+
+   pivot = *median3(first, last, less);
+   for(i = first, j = last - 2; ; )
+   {
+      while( less(*++i, pivot) )
+         ;
+      while( less(pivot, *--j) )
+         ;
+      if(i < j)
+         mySwapFH(*i, *j);
+      else
+         break;
+   }
+
+   mySwapFH(*i, *(last - 2));  // restore pivot
+   return i;
+}
+
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void quickSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   Iterator i;
+
+   if( last - first > QS_RECURSION_LIMIT )
+   {
+      i = quickSortPartition(first, last, less);
+
+      // recursive calls on smaller sub-groups
+      quickSort(first, i, less);
+      quickSort(i + 1, last, less);
+   }
+   else if (first != last)
+      // non-recursive escape valve - insertionSort
+      insertionSort(first, last, *first, less);
+}
+
+// introSort internal: quickSort partitioning, heapSortBottomUp once
+// depthLimit levels have been used up.  recurses only on the smaller side
+template <typename Iterator, typename Compare>
+void introSort(Iterator first, Iterator last, int depthLimit, Compare less)
+{
+   Iterator i;
+
+   while( last - first > QS_RECURSION_LIMIT )
+   {
+      if (depthLimit-- == 0)
+      {
+         heapSortBottomUp(first, last, less);
+         return;
+      }
+
+      i = quickSortPartition(first, last, less);
+
+      // recurse on the smaller sub-group, loop on the larger
+      if (i - first < last - i)
+      {
+         introSort(first, i, depthLimit, less);
+         first = i + 1;
+      }
+      else
+      {
+         introSort(i + 1, last, depthLimit, less);
+         last = i;
+      }
+   }
+
+   // non-recursive escape valve - insertionSort
+   if (first != last)
+      insertionSort(first, last, *first, less);
+}
+
+// introSort public driver - quickSort speed, O(n log n) guaranteed
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void introSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   int depthLimit, n;
+
+   for (depthLimit = 0, n = last - first; n > 1; n /= 2)
+      depthLimit += 2;        // 2 * floor(log2(n))
+   introSort(first, last, depthLimit, less);
+}
+
+// blockQuickSort internal: see FHsort.h.  leftmost is false when the item
+// just before first is an earlier pivot, which nothing in the range is
+// less than
+template <typename Iterator, typename Compare>
+void blockQuickSort(Iterator first, Iterator last, int depthLimit,
+   Compare less, bool leftmost)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   Iterator mid, pivotPos;
+
+   while (last - first > NETWORK_SORT_MAX)
+   {
+      if (depthLimit-- == 0)
+      {
+         heapSortBottomUp(first, last, less);
+         return;
+      }
+
+      // median of three to *first; the max, at last[-1], stops the first
+      // scan in blockPartition
+      mid = first + (last - first - 1) / 2;
+      compareExchange(*mid, *first, less);
+      compareExchange(*first, *(last - 1), less);
+      compareExchange(*mid, *first, less);
+
+      if (!leftmost && !less(*(first - 1), *first))
+      {
+         first = partitionEqualLeft(first, last, less) + 1;
+         continue;
+      }
+
+      pivotPos = blockPartition(first, last, less);
+      if (pivotPos - first < last - pivotPos)
+      {
+         blockQuickSort(first, pivotPos, depthLimit, less, leftmost);
+         first = pivotPos + 1;
+         leftmost = false;
+      }
+      else
+      {
+         blockQuickSort(pivotPos + 1, last, depthLimit, less, false);
+         last = pivotPos;
+      }
+   }
+
+   if (last - first < 2)
+      return;
+   if (is_arithmetic<Comparable>::value)
+      networkSort(first, last - first, less);
+   else
+      insertionSort(first, last, *first, less);
+}
+
+// blockQuickSort public driver - for int, float, double (and other cheap
+// to compare) keys.  not stable
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void blockQuickSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   int depthLimit, n;
+
+   for (depthLimit = 0, n = last - first; n > 1; n /= 2)
+      depthLimit += 2;
+   blockQuickSort(first, last, depthLimit, less, true);
+}
+
+// quickSort3Way - Bentley-McIlroy three-way partitioning (see FHsort.h).
+// for keys with many duplicates
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void quickSort3Way(Iterator first, Iterator last, Compare less = Compare())
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   Comparable pivot;
+   int i, j, p, q, k, right;
+
+   while( last - first > QS_RECURSION_LIMIT )
+   {
+      // median of three, moved to first[0]
+      mySwapFH(first[0], *median3(first, last, less));
+      pivot = first[0];
+
+      // first[0..p] and first[q..right] hold keys equal to the pivot
+      right = last - first - 1;
+      i = p = 0;
+      j = q = right + 1;
+      for ( ; ; )
+      {
+         while( less(first[++i], pivot) )
+            if (i == right)
+               break;
+         while( less(pivot, first[--j]) )
+            if (j == 0)
+               break;
+         if (i == j && !less(pivot, first[i]))
+            mySwapFH(first[++p], first[i]);
+         if (i >= j)
+            break;
+
+         mySwapFH(first[i], first[j]);
+         if ( !less(first[i], pivot) && !less(pivot, first[i]) )
+            mySwapFH(first[++p], first[i]);
+         if ( !less(first[j], pivot) && !less(pivot, first[j]) )
+            mySwapFH(first[--q], first[j]);
+      }
+
+      // swap the equal keys from both ends into the middle
+      i = j + 1;
+      for (k = 0; k <= p; k++)
+         mySwapFH(first[k], first[j--]);
+      for (k = right; k >= q; k--)
+         mySwapFH(first[k], first[i++]);
+
+      // now first[0..j] < pivot, first[i..right] > pivot
+      if (j < right - i)
+      {
+         quickSort3Way(first, first + j + 1, less);
+         first += i;
+      }
+      else
+      {
+         quickSort3Way(first + i, last, less);
+         last = first + j + 1;
+      }
+   }
+
+   // non-recursive escape valve - insertionSort
+   if (last - first > 1)
+      insertionSort(first, last, *first, less);
+}
+
+// selection helper: partitions [first, last) around *pivotPos and returns
+// its final position
+template <typename Iterator, typename Compare>
+Iterator partitionAround(Iterator first, Iterator last, Iterator pivotPos,
+   Compare less)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+   int i, j, right = last - first - 1;
+
+   mySwapFH(*pivotPos, first[right]);
+   const Comparable & pivot = first[right];
+   for (i = -1, j = right; ; )
+   {
+      while( less(first[++i], pivot) )
+         ;
+      while( less(pivot, first[--j]) )
+         if (j == 0)
+            break;
+      if (i < j)
+         mySwapFH(first[i], first[j]);
+      else
+         break;
+   }
+   mySwapFH(first[i], first[right]);
+   return first + i;
+}
+
+template <typename Iterator, typename Compare>
+void medianOfMediansSelect(Iterator first, Iterator nth, Iterator last,
+   Compare less);
+
+// selection helper: median of the medians of groups of 5 (see FHsort.h)
+template <typename Iterator, typename Compare>
+Iterator medianOfMediansPivot(Iterator first, Iterator last, Compare less)
+{
+   int k, groupEnd, numMedians = 0, arraySize = last - first;
+
+   // sort each group and move its median to the front
+   for (k = 0; k < arraySize; k += 5)
+   {
+      groupEnd = k + 5 < arraySize ? k + 5 : arraySize;
+      insertionSort(first + k, first + groupEnd, first[k], less);
+      mySwapFH(first[numMedians++], first[(k + groupEnd - 1) / 2]);
+   }
+
+   medianOfMediansSelect(first, first + (numMedians - 1) / 2,
+      first + numMedians, less);
+   return first + (numMedians - 1) / 2;
+}
+
+// selection helper: worst case O(n) select
+template <typename Iterator, typename Compare>
+void medianOfMediansSelect(Iterator first, Iterator nth, Iterator last,
+   Compare less)
+{
+   Iterator i;
+
+   while( last - first > QS_RECURSION_LIMIT )
+   {
+      i = partitionAround(first, last,
+         medianOfMediansPivot(first, last, less), less);
+      if (nth == i)
+         return;
+      if (nth < i)
+         last = i;
+      else
+         first = i + 1;
+   }
+   if (first != last)
+      insertionSort(first, last, *first, less);
+}
+
+// nthElement - introselect.  puts in *nth the item that would be there if
+// the range were sorted, with nothing greater before it and nothing less
+// after it.  worst case O(n)
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void nthElement(Iterator first, Iterator nth, Iterator last,
+   Compare less = Compare())
+{
+   Iterator i;
+   int steps, checkSize;
+
+   if (nth < first || nth >= last)
+      return;
+
+   for (steps = 0, checkSize = last - first;
+      last - first > QS_RECURSION_LIMIT; )
+   {
+      if (++steps == 3)
+      {
+         if (2 * (last - first) > checkSize)
+         {
+            medianOfMediansSelect(first, nth, last, less);
+            return;
+         }
+         steps = 0;
+         checkSize = last - first;
+      }
+
+      i = quickSortPartition(first, last, less);
+      if (nth == i)
+         return;
+      if (nth < i)
+         last = i;
+      else
+         first = i + 1;
+   }
+   insertionSort(first, last, *first, less);
+}
+
+// partialSort - sorts the least items into [first, middle); the order of
+// the rest is unspecified
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void partialSort(Iterator first, Iterator middle, Iterator last,
+   Compare less = Compare())
+{
+   int depthLimit, n;
+
+   if (middle <= first)
+      return;
+   if (middle >= last)
+   {
+      introSort(first, last, less);
+      return;
+   }
+
+   nthElement(first, middle - 1, last, less);
+   for (depthLimit = 0, n = middle - first - 1; n > 1; n /= 2)
+      depthLimit += 2;
+   introSort(first, middle - 1, depthLimit, less);
+}
+
+// the k greatest items of [first, last), greatest first
+template <typename Iterator, typename Comparable,
+   typename Compare = FHless<Comparable> >
+void topK(Iterator first, Iterator last, int k, FHvector<Comparable> & result,
+   Compare less = Compare())
+{
+   FHtopK<Comparable, Compare> best(k, less);
+
+   for ( ; first != last; ++first)
+      best.add(*first);
+   best.getResults(result);
+}
+
+// radixSort - stable LSD radix sort on a numeric key (see FHsort.h)
+template <typename Iterator, typename KeyFunc>
+void radixSort(Iterator first, Iterator last, KeyFunc getKey)
+{
+   FHvector<typename iterator_traits<Iterator>::value_type> a;
+
+   rangeToVector(first, last, a);
+   radixSort(a, getKey);
+   vectorToRange(a, first);
+}
+
+// version for ranges of numbers, sorted by their own value
+template <typename Iterator>
+void radixSort(Iterator first, Iterator last)
+{
+   typedef typename iterator_traits<Iterator>::value_type Comparable;
+
+   radixSort(first, last, [](const Comparable & x) { return x; });
+}
+
+// stringSort - multikey quicksort on a string key (see FHsort.h).  the
+// keys are extracted once and the items are then moved into place
+template <typename Iterator, typename KeyFunc>
+void stringSort(Iterator first, Iterator last, KeyFunc getKey)
+{
+   int k, arraySize = last - first;
+   FHvector<string> keys(arraySize);
+   FHvector<FHstringSortItem> items(arraySize);
+   FHvector<int> order(arraySize);
+
+   if (arraySize < 2)
+      return;
+
+   for (k = 0; k < arraySize; k++)
+   {
+      keys[k] = getKey(first[k]);
+      items[k].str = keys[k].data();
+      items[k].len = keys[k].size();
+      items[k].index = k;
+   }
+   stringSort(items, 0, arraySize - 1, 0);
+
+   for (k = 0; k < arraySize; k++)
+      order[k] = items[k].index;
+   applyOrder(first, order);
+}
+
+// version for ranges of strings
+template <typename Iterator>
+void stringSort(Iterator first, Iterator last)
+{
+   int k, arraySize = last - first;
+   FHvector<FHstringSortItem> items(arraySize);
+   FHvector<int> order(arraySize);
+
+   if (arraySize < 2)
+      return;
+
+   for (k = 0; k < arraySize; k++)
+   {
+      items[k].str = first[k].data();
+      items[k].len = first[k].size();
+      items[k].index = k;
+   }
+   stringSort(items, 0, arraySize - 1, 0);
+
+   for (k = 0; k < arraySize; k++)
+      order[k] = items[k].index;
+   applyOrder(first, order);
+}
+
+// indirect sort - sorts item positions instead of the items, then moves
+// each item once.  for items that are expensive to move
+template <typename Iterator, typename Compare = FHrangeLess<Iterator> >
+void indirectSort(Iterator first, Iterator last, Compare less = Compare())
+{
+   int k, arraySize = last - first;
+   FHvector<int> order(arraySize);
+
+   for( k = 0; k < arraySize; k++ )
+      order[k] = k;
+   quickSort(order, [first, &less](int x, int y)
+      { return less(first[x], first[y]); });
+   applyOrder(first, order);
+}
+
+// keySort - decorate, sort, undecorate (see FHsort.h).  stable
+template <typename Iterator, typename KeyFunc, typename KeyCompare>
+void keySort(Iterator first, Iterator last, KeyFunc getKey,
+   KeyCompare lessKey)
+{
+   typedef typename decay<decltype(getKey(*first))>::type Key;
+   int k, arraySize = last - first;
+   FHvector< FHkeyIndex<Key> > items(arraySize);
+   FHvector<int> order(arraySize);
+
+   if (arraySize < 2)
+      return;
+
+   for (k = 0; k < arraySize; k++)
+   {
+      items[k].key = getKey(first[k]);
+      items[k].index = k;
+   }
+   mergeSortBottomUp(items, [&lessKey](const FHkeyIndex<Key> & x,
+      const FHkeyIndex<Key> & y) { return lessKey(x.key, y.key); });
+
+   for (k = 0; k < arraySize; k++)
+      order[k] = items[k].index;
+   applyOrder(first, order);
+}
+
+template <typename Iterator, typename KeyFunc>
+void keySort(Iterator first, Iterator last, KeyFunc getKey)
+{
+   typedef typename decay<decltype(getKey(*first))>::type Key;
+
+   keySort(first, last, getKey, FHless<Key>());
+}
+
+#endif
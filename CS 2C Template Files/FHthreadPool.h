@@ -0,0 +1,258 @@
+// File FHthreadPool.h
+// Definitions for FHthreadPool and FHtaskGroup.
+// Work-stealing thread pool for fork/join algorithms (parallel sorts,
+// parallel heapify, ...).  Each thread has its own task deque: it pushes
+// and pops at the back (newest, cache-warm work first) and, when it runs
+// dry, steals from the front of another thread's deque (oldest, usually
+// the biggest piece of work).  A thread waiting on an FHtaskGroup runs
+// tasks instead of blocking, so nested fork/join never deadlocks.
+// An exception thrown by a task is caught on its thread, and wait()
+// rethrows the group's first one once all of the group's tasks are done.
+#ifndef FHTHREADPOOL_H
+#define FHTHREADPOOL_H
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <exception>
+using namespace std;
+
+// ---------------------- FHtaskGroup Prototype --------------------------
+// counts the tasks of one fork/join step that have not finished yet, and
+// keeps the first exception one of them threw
+class FHtaskGroup
+{
+public:
+   atomic<int> pending;
+   mutex errorLock;
+   exception_ptr error;
+   FHtaskGroup() : pending(0) { }
+};
+
+// ---------------------- FHthreadPool Prototype --------------------------
+class FHthreadPool
+{
+   // one deque per worker plus one shared by threads outside the pool
+   class TaskQueue
+   {
+   public:
+      mutex lock;
+      deque< function<void()> > tasks;
+   };
+
+private:
+   vector<thread> mWorkers;
+   TaskQueue *mQueues;
+   int mNumQueues;
+   atomic<int> mQueued;
+   atomic<bool> mStop;
+   mutex mSleepLock;
+   condition_variable mWakeUp;
+
+public:
+   FHthreadPool(int numThreads = 0);
+   ~FHthreadPool();
+
+   // numThreads counts the thread that calls wait(), which works too
+   int numThreads() const { return mNumQueues; }
+   void run(FHtaskGroup & group, const function<void()> & task);
+   void wait(FHtaskGroup & group);
+   void join(FHtaskGroup & group);
+
+private:
+   // owns threads - not copyable
+   FHthreadPool(const FHthreadPool & rhs);
+   FHthreadPool & operator=(const FHthreadPool & rhs);
+
+   int myQueue() const;
+   bool runOneTask();
+   void workerLoop(int index);
+   static int & threadIndex();
+   static const FHthreadPool * & threadPool();
+};
+
+// FHthreadPool method definitions -------------------
+// numThreads = 0 means one per hardware thread
+inline FHthreadPool::FHthreadPool(int numThreads)
+   : mQueued(0), mStop(false)
+{
+   int k;
+
+   if (numThreads <= 0)
+      numThreads = thread::hardware_concurrency();
+   if (numThreads <= 0)
+      numThreads = 1;
+
+   // workers own queues 0 .. numThreads-2; the last is for outside callers
+   mNumQueues = numThreads;
+   mQueues = new TaskQueue[mNumQueues];
+   for (k = 0; k < numThreads - 1; k++)
+      mWorkers.push_back( thread(&FHthreadPool::workerLoop, this, k) );
+}
+
+inline FHthreadPool::~FHthreadPool()
+{
+   int k;
+
+   {
+      lock_guard<mutex> guard(mSleepLock);
+      mStop = true;
+   }
+   mWakeUp.notify_all();
+   for (k = 0; k < (int)mWorkers.size(); k++)
+      mWorkers[k].join();
+   delete[] mQueues;
+}
+
+inline int & FHthreadPool::threadIndex()
+{
+   static thread_local int index = -1;
+   return index;
+}
+
+inline const FHthreadPool * & FHthreadPool::threadPool()
+{
+   static thread_local const FHthreadPool *pool = NULL;
+   return pool;
+}
+
+inline int FHthreadPool::myQueue() const
+{
+   if (threadPool() == this)
+      return threadIndex();
+   return mNumQueues - 1;
+}
+
+inline void FHthreadPool::run(FHtaskGroup & group,
+   const function<void()> & task)
+{
+   TaskQueue & queue = mQueues[myQueue()];
+
+   group.pending++;
+   try
+   {
+      lock_guard<mutex> guard(queue.lock);
+      queue.tasks.push_back( [&group, task]()
+      {
+         try
+         {
+            task();
+         }
+         catch (...)
+         {
+            lock_guard<mutex> guard(group.errorLock);
+            if (!group.error)
+               group.error = current_exception();
+         }
+         group.pending--;
+      } );
+   }
+   catch (...)
+   {
+      group.pending--;   // never queued
+      throw;
+   }
+   mQueued++;
+   mWakeUp.notify_one();
+}
+
+// pops from our own deque, else steals; false if there was nothing to run
+inline bool FHthreadPool::runOneTask()
+{
+   int k, mine = myQueue();
+   function<void()> task;
+
+   for (k = 0; k < mNumQueues && !task; k++)
+   {
+      TaskQueue & queue = mQueues[(mine + k) % mNumQueues];
+      lock_guard<mutex> guard(queue.lock);
+      if (queue.tasks.empty())
+         continue;
+      if (k == 0)
+      {
+         task = std::move(queue.tasks.back());
+         queue.tasks.pop_back();
+      }
+      else
+      {
+         task = std::move(queue.tasks.front());
+         queue.tasks.pop_front();
+      }
+   }
+   if (!task)
+      return false;
+
+   mQueued--;
+   task();
+   return true;
+}
+
+// helps run tasks (ours or stolen) until every task of group is done,
+// then rethrows the first exception any of them threw
+inline void FHthreadPool::wait(FHtaskGroup & group)
+{
+   exception_ptr error;
+
+   join(group);
+   if (group.error)
+   {
+      error = group.error;
+      group.error = nullptr;
+      rethrow_exception(error);
+   }
+}
+
+// wait() without the rethrow, for use while another exception unwinds
+inline void FHthreadPool::join(FHtaskGroup & group)
+{
+   while (group.pending.load() > 0)
+      if (!runOneTask())
+         this_thread::yield();
+}
+
+inline void FHthreadPool::workerLoop(int index)
+{
+   threadIndex() = index;
+   threadPool() = this;
+
+   while (!mStop.load())
+   {
+      if (runOneTask())
+         continue;
+
+      // nothing anywhere: sleep until a task is queued (the timeout covers
+      // a notify that lands between our check and the wait)
+      unique_lock<mutex> sleeping(mSleepLock);
+      mWakeUp.wait_for(sleeping, chrono::milliseconds(1),
+         [this]() { return mStop.load() || mQueued.load() > 0; });
+   }
+}
+
+// ---------------------- FHtaskGuard Prototype --------------------------
+// joins a task group when it goes out of scope.  forked tasks use the
+// forking function's locals by reference, so if that function leaves on
+// an exception before its wait(), they must finish first.  declare it
+// right after the group:
+//    FHtaskGroup group;
+//    FHtaskGuard guard(pool, group);
+class FHtaskGuard
+{
+private:
+   FHthreadPool & mPool;
+   FHtaskGroup & mGroup;
+
+public:
+   FHtaskGuard(FHthreadPool & pool, FHtaskGroup & group)
+      : mPool(pool), mGroup(group) { }
+   ~FHtaskGuard() { mPool.join(mGroup); }
+
+private:
+   FHtaskGuard(const FHtaskGuard & rhs);
+   FHtaskGuard & operator=(const FHtaskGuard & rhs);
+};
+
+#endif
@@ -2,34 +2,38 @@
 // Template definitions for sorting.  Specifically, include this file
 // to use for any array sort when the class overloads the < operator
 // Invoke:    arraySort(yourArray, arraySize);
+// or, with a comparator (see FHcompare.h):
+//            arraySort(yourArray, arraySize, EBookEntry::ByTitle());
  
 
 // #include "FHvector.h"
+#include "FHcompare.h"
 
 // prototypes ----------------------------------------------------
 template <typename Comparable>
 void mySwap(Comparable &a, Comparable &b);
 
-template <typename Comparable>
-bool floatLargestToTop(Comparable data[], int top);
+template <typename Comparable, typename Compare>
+bool floatLargestToTop(Comparable data[], int top, Compare less);
 
 // definitions ---------------------------------------------------
-template <typename Comparable>
-void arraySort(Comparable array[], int arraySize)
+// bubble sort: O(n^2), but stops after the first pass that moves nothing
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void bubbleSort(Comparable array[], int arraySize, Compare less = Compare())
 {
     for (int k = 0; k < arraySize; k++)
-       if (!floatLargestToTop(array, arraySize-1-k))
+       if (!floatLargestToTop(array, arraySize-1-k, less))
           return;
 }
 // returns true if a modification was made to the array
-template <typename Comparable>
-bool floatLargestToTop(Comparable data[], int top)
+template <typename Comparable, typename Compare>
+bool floatLargestToTop(Comparable data[], int top, Compare less)
 {
    bool changed = false;
    
    // notice we stop at length -2 because of expr. k+1 in loop
    for (int k =0; k < top; k++)
-      if (data[k+1] < data[k] )
+      if (less(data[k+1], data[k]))
       {
          mySwap(data[k], data[k+1]);
          changed = true;
@@ -47,8 +51,9 @@ void mySwap(Comparable &a, Comparable &b)
    b = temp;
 }
 
-template <typename Comparable>
-void insertionSort(Comparable array[], int arraySize)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void insertionSort(Comparable array[], int arraySize,
+   Compare less = Compare())
 {
    int k, pos;
    Comparable tmp;
@@ -56,15 +61,15 @@ void insertionSort(Comparable array[], int arraySize)
    for(pos = 1; pos < arraySize; pos++ )
    {
       tmp = array[pos];
-      for(k = pos; k > 0 && tmp < array[k-1]; k-- )
+      for(k = pos; k > 0 && less(tmp, array[k-1]); k-- )
          array[k] = array[k-1];
       array[k] = tmp;
    }
 }
 
 // shellsort #1 -- using shell's outer loop
-template <typename Comparable>
-void shellSort1( Comparable array[], int arraySize )
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void shellSort1( Comparable array[], int arraySize, Compare less = Compare() )
 {
    int k, pos, gap;
    Comparable tmp;
@@ -73,34 +78,36 @@ void shellSort1( Comparable array[], int arraySize )
       for(pos = gap ; pos < arraySize; pos++ )
       {
          tmp = array[pos];
-         for(k = pos; k >= gap && tmp < array[k - gap]; k -= gap )
+         for(k = pos; k >= gap && less(tmp, array[k - gap]); k -= gap )
             array[k] = array[k - gap];
          array[k] = tmp;
    }
 }
 
 // forward declarations
-template <typename Comparable>
-void mergeSort(Comparable array[], Comparable workingArray[], int arraySize);
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void mergeSort(Comparable array[], Comparable workingArray[], int arraySize,
+   Compare less = Compare());
 
-template <typename Comparable>
+template <typename Comparable, typename Compare = FHless<Comparable> >
 void merge(Comparable client[], Comparable working[], 
-   int rightPos, int arraySize);
+   int rightPos, int arraySize, Compare less = Compare());
 
-template <typename Comparable>
-void mergeSort(Comparable array[], int arraySize)
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void mergeSort(Comparable array[], int arraySize, Compare less = Compare())
 {
    if (arraySize < 2)
       return;
 
    Comparable *working = new Comparable[arraySize];
-   mergeSort(array, working, arraySize);
+   mergeSort(array, working, arraySize, less);
    delete[] working;
 }
 
 // mergeSort internal function
-template <typename Comparable>
-void mergeSort(Comparable array[], Comparable workingArray[], int arraySize)
+template <typename Comparable, typename Compare>
+void mergeSort(Comparable array[], Comparable workingArray[], int arraySize,
+   Compare less)
 {
    int rightStart;
 
@@ -108,17 +115,17 @@ void mergeSort(Comparable array[], Comparable workingArray[], int arraySize)
       return;
 
    rightStart = arraySize/2;
-   mergeSort(array, workingArray, rightStart);
-   mergeSort(array + rightStart, workingArray, arraySize - rightStart);
-   merge(array, workingArray, rightStart, arraySize);
+   mergeSort(array, workingArray, rightStart, less);
+   mergeSort(array + rightStart, workingArray, arraySize - rightStart, less);
+   merge(array, workingArray, rightStart, arraySize, less);
 }
 
 // input array 1:  client[0] ... client[rightPos-1]
 // input array 2:  client[rightPos] ... client[arraySize - 1]
 // working[] array supplied by client to avoid local allocation
-template <typename Comparable>
+template <typename Comparable, typename Compare>
 void merge(Comparable client[], Comparable working[], 
-   int rightPos, int arraySize)
+   int rightPos, int arraySize, Compare less)
 {
    int leftPos, leftStop, rightStop, workingPos;
 
@@ -128,7 +135,7 @@ void merge(Comparable client[], Comparable working[],
 
    // as soon as we reach the end of either input array, stop
    while(leftPos <= leftStop && rightPos <= rightStop)
-      if(client[leftPos] <= client[rightPos])
+      if( !less(client[rightPos], client[leftPos]) )
          working[workingPos++] = client[leftPos++];
       else
          working[workingPos++] = client[rightPos++];
@@ -143,3 +150,11 @@ void merge(Comparable client[], Comparable working[],
    for( ; rightStop >= 0; rightStop-- )
       client[rightStop] = working[rightStop];
 }
+
+// arraySort - the general purpose sort: mergeSort, which is O(n log n)
+// and, like bubbleSort, stable
+template <typename Comparable, typename Compare = FHless<Comparable> >
+void arraySort(Comparable array[], int arraySize, Compare less = Compare())
+{
+   mergeSort(array, arraySize, less);
+}
@@ -92,7 +92,100 @@ public:
    bool operator<(const StarNearEarth &other) const;
    bool operator>(const StarNearEarth &other) const;
    bool operator==(const StarNearEarth &other) const;
-   bool operator!=(const StarNearEarth &other) const;};
+   bool operator!=(const StarNearEarth &other) const;
+
+   // per-field comparators (see FHcompare.h)
+   class ByNameCns
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.nameCns < b.nameCns; }
+   };
+   class BySpectralType
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.spectralType < b.spectralType; }
+   };
+   class ByNameCommon
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.nameCommon < b.nameCommon; }
+   };
+   class ByRank
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.rank < b.rank; }
+   };
+   class ByNameLhs
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.nameLhs < b.nameLhs; }
+   };
+   class ByNumComponents
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.numComponents < b.numComponents; }
+   };
+   class ByRA
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.rAsc < b.rAsc; }
+   };
+   class ByDec
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.decl < b.decl; }
+   };
+   class ByPropMotionMag
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.propMotionMag < b.propMotionMag; }
+   };
+   class ByPropMotionDir
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.propMotionDir < b.propMotionDir; }
+   };
+   class ByParallaxMean
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.parallaxMean < b.parallaxMean; }
+   };
+   class ByParallaxVariance
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.parallaxVariance < b.parallaxVariance; }
+   };
+   class ByMagApparent
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.magApparent < b.magApparent; }
+   };
+   class ByMagAbsolute
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.magAbsolute < b.magAbsolute; }
+   };
+   class ByMass
+   {
+   public:
+      bool operator()(const StarNearEarth &a, const StarNearEarth &b) const
+         { return a.mass < b.mass; }
+   };
+};
 
 class StarNearEarthReader
 {
@@ -57,6 +57,27 @@ public:
    bool operator==(const iTunesEntry &other) const;
    bool operator!=(const iTunesEntry &other) const;
    string getArtistLastName() const;
+
+   // per-field comparators (see FHcompare.h)
+   class ByTitle
+   {
+   public:
+      bool operator()(const iTunesEntry &a, const iTunesEntry &b) const
+         { return a.title < b.title; }
+   };
+   class ByArtist
+   {
+   public:
+      bool operator()(const iTunesEntry &a, const iTunesEntry &b) const
+         { return a.getArtistLastName() + a.artist
+            < b.getArtistLastName() + b.artist; }
+   };
+   class ByTime
+   {
+   public:
+      bool operator()(const iTunesEntry &a, const iTunesEntry &b) const
+         { return a.tuneTime < b.tuneTime; }
+   };
 };
 
 class iTunesEntryReader